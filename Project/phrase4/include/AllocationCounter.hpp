@@ -0,0 +1,7 @@
+#pragma once
+#include <cstddef>
+
+// Heap allocations made through global operator new since process start.
+// Only counts in executables that link src/AllocationCounter.cpp, which
+// replaces the global operator new/delete (hft_app, for --alloc-report).
+size_t allocationCount();
@@ -0,0 +1,158 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One aggregated price level as published in the L2 depth view
+template <typename PriceType>
+struct DepthLevel {
+    PriceType price{};
+    long long quantity = 0;
+    uint32_t order_count = 0;
+};
+
+// A level whose visible state changed. quantity == 0 means the level left
+// the top-N view (emptied, or pushed out by a better level).
+template <typename PriceType>
+struct DepthUpdate {
+    PriceType price;
+    long long quantity;
+    uint32_t order_count;
+    bool is_buy;
+};
+
+// Top-N L2 depth for one book, kept up to date by OrderBook as levels
+// change rather than rebuilt on read. Each side is a fixed array of N
+// levels sorted best first; a change outside the visible window costs one
+// price comparison. Reads (bid(i), ask(i), updates()) never allocate.
+//
+// Changed levels are also appended to an update list, coalesced when the
+// same level changes repeatedly (e.g. a sweep filling several orders at
+// one price). MatchingEngine clears it at the start of every matchOrder,
+// so afterwards it holds exactly that call's deltas for a publisher.
+template <typename PriceType>
+class BookDepth {
+public:
+    using Level = DepthLevel<PriceType>;
+    using Update = DepthUpdate<PriceType>;
+
+    // Track the top `levels` levels per side (0 disables tracking)
+    void configure(size_t levels, size_t update_capacity = 256) {
+        max_levels = levels;
+        bids.assign(levels, Level{});
+        asks.assign(levels, Level{});
+        bid_count = 0;
+        ask_count = 0;
+        updates_list.clear();
+        updates_list.reserve(levels ? update_capacity : 0);
+    }
+
+    bool enabled() const { return max_levels != 0; }
+    size_t maxLevels() const { return max_levels; }
+
+    size_t bidDepth() const { return bid_count; }
+    size_t askDepth() const { return ask_count; }
+    const Level& bid(size_t i) const { return bids[i]; }
+    const Level& ask(size_t i) const { return asks[i]; }
+
+    const std::vector<Update>& updates() const { return updates_list; }
+    void clearUpdates() { updates_list.clear(); }
+
+    // Could a change at this price alter the visible levels? True while the
+    // side shows fewer than N levels (every book level is visible then).
+    bool inWindow(bool is_buy, PriceType price) const {
+        size_t count = is_buy ? bid_count : ask_count;
+        if (count < max_levels) return true;
+        if (max_levels == 0) return false;
+        const Level& worst = is_buy ? bids[count - 1] : asks[count - 1];
+        return !better(is_buy, worst.price, price);
+    }
+
+    // New state of a level inside the window (quantity 0: level is gone).
+    // Returns true when a full side lost a level, in which case the book
+    // should offer the next level below the window through refill().
+    bool apply(bool is_buy, PriceType price, long long quantity, size_t order_count) {
+        std::vector<Level>& side = is_buy ? bids : asks;
+        size_t& count = is_buy ? bid_count : ask_count;
+
+        size_t pos = 0;
+        while (pos < count && better(is_buy, side[pos].price, price)) ++pos;
+
+        if (pos < count && side[pos].price == price) {
+            if (quantity > 0) {
+                side[pos].quantity = quantity;
+                side[pos].order_count = static_cast<uint32_t>(order_count);
+                publish(is_buy, side[pos]);
+                return false;
+            }
+            bool was_full = (count == max_levels);
+            publish(is_buy, Level{price, 0, 0});
+            for (size_t i = pos + 1; i < count; ++i) side[i - 1] = side[i];
+            --count;
+            return was_full;
+        }
+
+        if (quantity <= 0 || pos == max_levels) return false;
+
+        // New level: shift worse levels down, the last one falls out of view
+        if (count == max_levels) {
+            publish(is_buy, Level{side[count - 1].price, 0, 0});
+            --count;
+        }
+        for (size_t i = count; i > pos; --i) side[i] = side[i - 1];
+        side[pos] = Level{price, quantity, static_cast<uint32_t>(order_count)};
+        ++count;
+        publish(is_buy, side[pos]);
+        return false;
+    }
+
+    // Price after which the book should look for a refill level
+    // (false: the side is empty, start from the book's best level)
+    bool lastPrice(bool is_buy, PriceType& price) const {
+        size_t count = is_buy ? bid_count : ask_count;
+        if (count == 0) return false;
+        price = is_buy ? bids[count - 1].price : asks[count - 1].price;
+        return true;
+    }
+
+    // Append the next book level below the window after apply() freed a slot
+    void refill(bool is_buy, PriceType price, long long quantity, size_t order_count) {
+        std::vector<Level>& side = is_buy ? bids : asks;
+        size_t& count = is_buy ? bid_count : ask_count;
+        if (count == max_levels) return;
+        side[count] = Level{price, quantity, static_cast<uint32_t>(order_count)};
+        publish(is_buy, side[count]);
+        ++count;
+    }
+
+    // Drop all visible levels (book cleared); no updates are published
+    void reset() {
+        bid_count = 0;
+        ask_count = 0;
+        updates_list.clear();
+    }
+
+private:
+    static bool better(bool is_buy, PriceType a, PriceType b) {
+        return is_buy ? a > b : a < b;
+    }
+
+    void publish(bool is_buy, const Level& level) {
+        if (!updates_list.empty()) {
+            Update& last = updates_list.back();
+            if (last.is_buy == is_buy && last.price == level.price) {
+                last.quantity = level.quantity;
+                last.order_count = level.order_count;
+                return;
+            }
+        }
+        updates_list.push_back(Update{level.price, level.quantity, level.order_count, is_buy});
+    }
+
+    size_t max_levels = 0;
+    std::vector<Level> bids;
+    std::vector<Level> asks;
+    size_t bid_count = 0;
+    size_t ask_count = 0;
+    std::vector<Update> updates_list;
+};
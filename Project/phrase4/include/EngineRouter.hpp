@@ -0,0 +1,202 @@
+#pragma once
+#include "Order.hpp"
+#include "OrderBook.hpp"
+#include "MatchingEngine.hpp"
+#include "SpscQueue.hpp"
+#include "Symbol.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Order intent routed to a shard. Plain data, so it can cross threads;
+// the shard builds the actual Order from its own pool.
+template <typename PriceType, typename OrderIdType>
+struct OrderRequest {
+    OrderIdType id;
+    SymbolId symbol;
+    PriceType price;
+    int quantity;
+    bool is_buy;
+};
+
+// Multi-symbol matching front end. Owns one OrderBook + MatchingEngine per
+// symbol and partitions symbols across N shard threads (round robin at
+// registration). A single producer thread submits requests; each shard is
+// fed through its own bounded SPSC queue and is the only thread touching
+// its books and order pool, so the matching path stays lock-free.
+// BookType picks the per-symbol book layout (see OrderBook's policies).
+template <typename PriceType, typename OrderIdType,
+          typename BookType = OrderBook<PriceType, OrderIdType>>
+class EngineRouter {
+public:
+    using OrderType = Order<PriceType, OrderIdType>;
+    using OrderPtr = UniqueOrderPtr<PriceType, OrderIdType>;
+    using OrderBookType = BookType;
+    using MatchingEngineType = MatchingEngine<PriceType, OrderIdType, BookType>;
+    using RequestType = OrderRequest<PriceType, OrderIdType>;
+
+    // Returned by submit() for a rejected request (ids start at 1)
+    static constexpr OrderIdType invalid_order_id = 0;
+
+private:
+    struct SymbolBook {
+        OrderBookType book;
+        MatchingEngineType engine;
+
+        // No trade history: fills are streamed through the sink in process()
+        explicit SymbolBook(const std::string& symbol) : book(symbol), engine(book, false) {}
+    };
+
+    struct Shard {
+        SpscQueue<RequestType> queue;
+        OrderPool<PriceType, OrderIdType> pool;
+        std::thread worker;
+        std::atomic<uint64_t> processed{0};
+        uint64_t trades = 0;  // worker-owned, read after stop()
+
+        Shard(size_t queue_capacity, size_t orders_per_shard)
+            : queue(queue_capacity), pool(1024) {
+            pool.reserve(orders_per_shard);
+        }
+    };
+
+    // Declared before the books: pools must outlive the orders resting in them
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::unique_ptr<SymbolBook>> books;
+
+    // Routing tables indexed by SymbolId (nullptr / unused for unknown ids)
+    std::vector<SymbolBook*> book_by_symbol;
+    std::vector<uint32_t> shard_by_symbol;
+
+    std::atomic<bool> running{false};
+    OrderIdType next_order_id = 1;
+    bool pin_threads;
+
+public:
+    explicit EngineRouter(size_t num_shards, size_t queue_capacity = 65536,
+                          size_t orders_per_shard = 65536, bool pin = true)
+        : pin_threads(pin) {
+        if (num_shards == 0) num_shards = 1;
+        for (size_t i = 0; i < num_shards; ++i) {
+            shards.push_back(std::make_unique<Shard>(queue_capacity, orders_per_shard));
+        }
+    }
+
+    ~EngineRouter() { stop(); }
+
+    EngineRouter(const EngineRouter&) = delete;
+    EngineRouter& operator=(const EngineRouter&) = delete;
+
+    // Register a symbol (before start()); returns its id
+    SymbolId addSymbol(const std::string& symbol) {
+        SymbolId id = internSymbol(symbol);
+        if (id >= book_by_symbol.size()) {
+            book_by_symbol.resize(id + 1, nullptr);
+            shard_by_symbol.resize(id + 1, 0);
+        }
+        if (!book_by_symbol[id]) {
+            books.push_back(std::make_unique<SymbolBook>(symbol));
+            book_by_symbol[id] = books.back().get();
+            shard_by_symbol[id] = static_cast<uint32_t>((books.size() - 1) % shards.size());
+        }
+        return id;
+    }
+
+    void start() {
+        if (running.exchange(true)) return;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            shards[i]->worker = std::thread([this, i] { runShard(*shards[i]); });
+            if (pin_threads) pinToCore(shards[i]->worker, i);
+        }
+    }
+
+    // Drain all queues and join the shard threads
+    void stop() {
+        if (!running.exchange(false)) return;
+        for (auto& shard : shards) {
+            if (shard->worker.joinable()) shard->worker.join();
+        }
+    }
+
+    // Producer side (single thread). Spins while the target shard's queue
+    // is full, which applies backpressure. Returns the assigned order id, or
+    // invalid_order_id without enqueueing anything if the symbol was never
+    // registered or the quantity is outside 1..OrderType::max_quantity.
+    OrderIdType submit(SymbolId symbol, PriceType price, int quantity, bool is_buy) {
+        if (symbol >= book_by_symbol.size() || !book_by_symbol[symbol]) return invalid_order_id;
+        if (quantity <= 0 || quantity > OrderType::max_quantity) return invalid_order_id;
+
+        RequestType request{next_order_id++, symbol, price, quantity, is_buy};
+        Shard& shard = *shards[shard_by_symbol[symbol]];
+        while (!shard.queue.tryPush(request)) {
+            std::this_thread::yield();
+        }
+        return request.id;
+    }
+
+    size_t getShardCount() const { return shards.size(); }
+    size_t getSymbolCount() const { return books.size(); }
+
+    uint64_t getProcessedCount() const {
+        uint64_t total = 0;
+        for (const auto& shard : shards) total += shard->processed.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Totals below are only stable after stop()
+    uint64_t getTradeCount() const {
+        uint64_t total = 0;
+        for (const auto& shard : shards) total += shard->trades;
+        return total;
+    }
+
+    const OrderBookType* getBook(SymbolId symbol) const {
+        return (symbol < book_by_symbol.size() && book_by_symbol[symbol])
+            ? &book_by_symbol[symbol]->book : nullptr;
+    }
+
+private:
+    void runShard(Shard& shard) {
+        RequestType request;
+        while (true) {
+            if (shard.queue.tryPop(request)) {
+                process(shard, request);
+                continue;
+            }
+            // Exit only once stopped and fully drained
+            if (!running.load(std::memory_order_acquire) && shard.queue.empty()) break;
+            std::this_thread::yield();
+        }
+    }
+
+    // submit() only enqueues requests for registered symbols
+    void process(Shard& shard, const RequestType& request) {
+        SymbolBook* target = book_by_symbol[request.symbol];
+
+        OrderPtr order(shard.pool.allocate(), PoolDeleter<OrderType>{&shard.pool});
+        *order = OrderType(request.id, request.price, request.quantity, request.is_buy);
+
+        shard.trades += target->engine.matchOrder(std::move(order), [](const auto&) {});
+        shard.processed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void pinToCore(std::thread& thread, size_t index) {
+#if defined(__linux__)
+        unsigned cores = std::thread::hardware_concurrency();
+        if (cores == 0) return;
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(index % cores, &cpuset);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+#else
+        (void)thread;
+        (void)index;
+#endif
+    }
+};
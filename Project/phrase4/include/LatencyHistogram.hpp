@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// HDR-style log-linear latency histogram (values in nanoseconds).
+// Values are grouped into power-of-two buckets, each split into a fixed
+// number of linear sub-buckets, so every recorded value is kept to the
+// requested number of significant decimal digits. Memory is fixed at
+// construction and record() is O(1) with no allocation, so it can sit in
+// a hot loop for billions of samples. Instances with the same
+// configuration can be merged (e.g. one per thread).
+class LatencyHistogram {
+public:
+    // significant_digits: 1-5 (3 keeps every value within 0.1%)
+    // highest_trackable: larger samples are clamped into the top bucket
+    //                    (max() still reports them exactly)
+    explicit LatencyHistogram(int significant_digits = 3,
+                              int64_t highest_trackable = 100000000000LL);  // 100 s
+
+    void record(int64_t value) {
+        if (value < 0) value = 0;
+        if (value < min_value) min_value = value;
+        if (value > max_value) max_value = value;
+        ++total_count;
+        double v = static_cast<double>(value);
+        sum += v;
+        sum_squares += v * v;
+        counts[indexFor(value < highest_trackable ? value : highest_trackable)]++;
+    }
+
+    // Add another histogram's samples; throws std::invalid_argument if the
+    // two were built with different precision or range
+    void merge(const LatencyHistogram& other);
+
+    void reset();
+
+    uint64_t count() const { return total_count; }
+    bool empty() const { return total_count == 0; }
+    int64_t min() const { return total_count ? min_value : 0; }
+    int64_t max() const { return total_count ? max_value : 0; }
+    double mean() const;
+    double stddev() const;
+
+    // Value at percentile p (0-100): the highest value equivalent to the
+    // bucket holding that rank, capped at max()
+    int64_t percentile(double p) const;
+
+    // Write the percentile distribution in HdrHistogram's .hgrm text layout
+    // (loadable by the HdrHistogram plotter). Returns false on I/O error.
+    bool exportDistribution(const std::string& path) const;
+
+    size_t memoryBytes() const { return counts.size() * sizeof(uint64_t); }
+    int significantDigits() const { return digits; }
+
+private:
+    size_t indexFor(int64_t value) const {
+        // Bucket 0 is linear over [0, sub_bucket_count); bucket b >= 1 covers
+        // [sub_bucket_count << (b - 1), sub_bucket_count << b) in steps of 2^b
+        uint64_t v = static_cast<uint64_t>(value);
+        int bucket = log2Floor(v | sub_bucket_mask) - (sub_bucket_bits - 1);
+        return (static_cast<size_t>(bucket) << (sub_bucket_bits - 1)) + static_cast<size_t>(v >> bucket);
+    }
+
+    static int log2Floor(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(v);
+#else
+        int r = 0;
+        while (v >>= 1) ++r;
+        return r;
+#endif
+    }
+
+    int64_t lowestEquivalent(size_t index) const;
+    int64_t highestEquivalent(size_t index) const;
+
+    int digits;
+    int64_t highest_trackable;
+    int sub_bucket_bits;       // log2(sub-buckets per bucket)
+    uint64_t sub_bucket_mask;  // sub_bucket_count - 1
+    std::vector<uint64_t> counts;
+
+    uint64_t total_count = 0;
+    int64_t min_value = INT64_MAX;
+    int64_t max_value = 0;
+    double sum = 0.0;
+    double sum_squares = 0.0;
+};
@@ -0,0 +1,196 @@
+#pragma once
+#include "Order.hpp"
+#include "MemoryPool.hpp"
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+// Baseline order book: one std::multimap node per resting order.
+// Kept as the reference implementation for benchmarking OrderBook.
+template <typename PriceType, typename OrderIdType>
+class MapOrderBook {
+public:
+    using OrderType = Order<PriceType, OrderIdType>;
+    using OrderPtr = UniqueOrderPtr<PriceType, OrderIdType>;
+
+private:
+    // Buy orders: higher price has priority (max heap behavior)
+    // Use greater for descending order
+    std::multimap<PriceType, OrderPtr, std::greater<PriceType>> buy_orders;
+    
+    // Sell orders: lower price has priority (min heap behavior)
+    std::multimap<PriceType, OrderPtr, std::less<PriceType>> sell_orders;
+    
+    // id -> price of each resting order, so cancel can find its node
+    std::unordered_map<OrderIdType, PriceType> resting;
+
+    std::string symbol;
+    SymbolId symbol_id;
+    MemoryPool<OrderType> memory_pool;
+
+public:
+    explicit MapOrderBook(const std::string& sym)
+        : symbol(sym), symbol_id(internSymbol(sym)), memory_pool(1024) {}
+
+    // Add a buy order
+    void addBuyOrder(OrderPtr order) {
+        if (order && order->is_buy) {
+            resting[order->id] = order->price;
+            buy_orders.emplace(order->price, std::move(order));
+        }
+    }
+
+    // Add a sell order
+    void addSellOrder(OrderPtr order) {
+        if (order && !order->is_buy) {
+            resting[order->id] = order->price;
+            sell_orders.emplace(order->price, std::move(order));
+        }
+    }
+
+    // Add order (automatically determines buy/sell)
+    void addOrder(OrderPtr order) {
+        if (!order) return;
+        
+        if (order->is_buy) {
+            addBuyOrder(std::move(order));
+        } else {
+            addSellOrder(std::move(order));
+        }
+    }
+
+    // Get best bid (highest buy price)
+    PriceType getBestBid() const {
+        if (buy_orders.empty()) return PriceType{};
+        return buy_orders.begin()->first;
+    }
+
+    // Get best ask (lowest sell price)
+    PriceType getBestAsk() const {
+        if (sell_orders.empty()) return PriceType{};
+        return sell_orders.begin()->first;
+    }
+
+    // Check if orders can be matched
+    bool canMatch() const {
+        if (buy_orders.empty() || sell_orders.empty()) return false;
+        return getBestBid() >= getBestAsk();
+    }
+
+    // Get top buy orders
+    std::vector<const OrderType*> getTopBuyOrders(size_t count = 5) const {
+        std::vector<const OrderType*> result;
+        result.reserve(count);
+        
+        auto it = buy_orders.begin();
+        for (size_t i = 0; i < count && it != buy_orders.end(); ++i, ++it) {
+            result.push_back(it->second.get());
+        }
+        return result;
+    }
+
+    // Get top sell orders
+    std::vector<const OrderType*> getTopSellOrders(size_t count = 5) const {
+        std::vector<const OrderType*> result;
+        result.reserve(count);
+        
+        auto it = sell_orders.begin();
+        for (size_t i = 0; i < count && it != sell_orders.end(); ++i, ++it) {
+            result.push_back(it->second.get());
+        }
+        return result;
+    }
+
+    // Remove and return the best buy order
+    OrderPtr popBestBuy() {
+        if (buy_orders.empty()) return nullptr;
+        
+        auto it = buy_orders.begin();
+        OrderPtr order = std::move(it->second);
+        buy_orders.erase(it);
+        resting.erase(order->id);
+        return order;
+    }
+
+    // Remove and return the best sell order
+    OrderPtr popBestSell() {
+        if (sell_orders.empty()) return nullptr;
+        
+        auto it = sell_orders.begin();
+        OrderPtr order = std::move(it->second);
+        sell_orders.erase(it);
+        resting.erase(order->id);
+        return order;
+    }
+
+    // Best resting orders, left in the book (nullptr if that side is empty)
+    OrderType* peekBestBuy() const {
+        return buy_orders.empty() ? nullptr : buy_orders.begin()->second.get();
+    }
+
+    OrderType* peekBestSell() const {
+        return sell_orders.empty() ? nullptr : sell_orders.begin()->second.get();
+    }
+
+    // Fill the best resting order in place, erasing it once fully filled
+    void fillBestBuy(int quantity) {
+        auto it = buy_orders.begin();
+        it->second->quantity -= quantity;
+        if (it->second->quantity <= 0) {
+            resting.erase(it->second->id);
+            buy_orders.erase(it);
+        }
+    }
+
+    void fillBestSell(int quantity) {
+        auto it = sell_orders.begin();
+        it->second->quantity -= quantity;
+        if (it->second->quantity <= 0) {
+            resting.erase(it->second->id);
+            sell_orders.erase(it);
+        }
+    }
+
+    // Cancel a resting order: hash lookup for its price, then a scan of the
+    // orders resting at that price. False if the id is not resting.
+    bool cancelOrder(OrderIdType id) {
+        auto found = resting.find(id);
+        if (found == resting.end()) return false;
+        PriceType price = found->second;
+        resting.erase(found);
+        return eraseById(buy_orders, price, id) || eraseById(sell_orders, price, id);
+    }
+
+    // Get statistics
+    size_t getBuyOrderCount() const { return buy_orders.size(); }
+    size_t getSellOrderCount() const { return sell_orders.size(); }
+    size_t getTotalOrderCount() const { return buy_orders.size() + sell_orders.size(); }
+
+    const std::string& getSymbol() const { return symbol; }
+    SymbolId getSymbolId() const { return symbol_id; }
+
+    // No depth view in the baseline book (called by MatchingEngine)
+    void clearDepthUpdates() {}
+
+    // Clear all orders
+    void clear() {
+        buy_orders.clear();
+        sell_orders.clear();
+        resting.clear();
+    }
+
+private:
+    template <typename Side>
+    static bool eraseById(Side& side, PriceType price, OrderIdType id) {
+        auto range = side.equal_range(price);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->id == id) {
+                side.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+};
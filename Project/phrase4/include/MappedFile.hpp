@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Symbol.hpp"
+
+// Header shared by the memory-mapped record files (trade journal, session
+// recordings). record_count is republished on every flush(), so a reader
+// sees a consistent prefix even while the file is still being written.
+// The symbol table (uint32 length + bytes per SymbolId) is appended on close.
+struct MappedFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count;
+    uint64_t symbol_table_offset;  // 0 until the file is closed
+    uint64_t symbol_count;
+};
+
+// Append-only file of fixed-size records backed by a memory mapping.
+// append() is a bounds check plus a memcpy into the mapping; the file grows
+// in large chunks (remapped on growth) and is truncated to size on close.
+class MappedRecordWriter {
+public:
+    static constexpr size_t default_chunk_bytes = size_t{64} << 20;
+
+    MappedRecordWriter(const std::string& path, const char (&magic)[8], uint32_t version,
+                       uint32_t record_size, size_t chunk_bytes = default_chunk_bytes);
+    ~MappedRecordWriter();
+
+    MappedRecordWriter(const MappedRecordWriter&) = delete;
+    MappedRecordWriter& operator=(const MappedRecordWriter&) = delete;
+
+    bool isOpen() const { return base != nullptr; }
+
+    // Record must be the type the file was opened for (sizeof == record_size).
+    // Returns false, and counts the record in failedCount(), if the file
+    // could not grow (disk full, mapping failed) or is closed.
+    template <typename Record>
+    bool append(const Record& record) {
+        if (write_offset + sizeof(Record) > mapped_bytes && !grow()) {
+            ++failed_count;
+            return false;
+        }
+        std::memcpy(base + write_offset, &record, sizeof(Record));
+        write_offset += sizeof(Record);
+        ++record_count;
+        return true;
+    }
+
+    // Publish the record count in the header (no syscall)
+    void flush();
+
+    // Write the symbol table, truncate to the used size and unmap
+    void close();
+
+    uint64_t recordCount() const { return record_count; }
+    uint64_t failedCount() const { return failed_count; }
+    const std::string& path() const { return file_path; }
+
+private:
+    bool grow();
+
+    std::string file_path;
+    size_t chunk;
+    int fd;
+    char* base;
+    size_t mapped_bytes;
+    size_t write_offset;
+    uint64_t record_count;
+    uint64_t failed_count;
+};
+
+// Read-only mapping of a record file. Closed (isOpen() == false) if the
+// file is missing or its magic / record size don't match.
+class MappedRecordReader {
+public:
+    MappedRecordReader(const std::string& path, const char (&magic)[8], uint32_t record_size);
+    ~MappedRecordReader();
+
+    MappedRecordReader(const MappedRecordReader&) = delete;
+    MappedRecordReader& operator=(const MappedRecordReader&) = delete;
+
+    bool isOpen() const { return base != nullptr; }
+
+    uint64_t recordCount() const { return record_count; }
+
+    template <typename Record>
+    const Record* records() const {
+        return reinterpret_cast<const Record*>(base + sizeof(MappedFileHeader));
+    }
+
+    // Symbol name recorded for an id ("" if unknown)
+    const std::string& symbol(uint32_t id) const;
+    size_t symbolCount() const { return symbols.size(); }
+
+    // Recorded ids mapped to this process's interned ids
+    std::vector<SymbolId> internSymbols() const;
+
+private:
+    int fd;
+    const char* base;
+    size_t file_bytes;
+    uint64_t record_count;
+    std::vector<std::string> symbols;
+};
@@ -2,40 +2,140 @@
 #include <string>
 #include <chrono>
 #include <vector>
-#include <random>
+#include <cstdint>
+#include <cstddef>
+#include "Symbol.hpp"
 
 // Cache-line aligned market data structure for optimal performance
 struct alignas(64) MarketData {
-    std::string symbol;
+    SymbolId symbol;
     double bid_price;
     double ask_price;
     int bid_size;
     int ask_size;
     std::chrono::high_resolution_clock::time_point timestamp;
 
-    MarketData(std::string sym, double bid, double ask, int bid_sz = 100, int ask_sz = 100)
-        : symbol(std::move(sym)), bid_price(bid), ask_price(ask), 
+    MarketData(SymbolId sym, double bid, double ask, int bid_sz = 100, int ask_sz = 100)
+        : symbol(sym), bid_price(bid), ask_price(ask), 
           bid_size(bid_sz), ask_size(ask_sz),
           timestamp(std::chrono::high_resolution_clock::now()) {}
     
-    MarketData() : symbol(""), bid_price(0.0), ask_price(0.0), 
+    MarketData() : symbol(0), bid_price(0.0), ask_price(0.0), 
                    bid_size(0), ask_size(0),
                    timestamp(std::chrono::high_resolution_clock::now()) {}
 };
 
+// Structure-of-arrays tick batch: one column per field, so consumers (and
+// the generator) stream through contiguous bid/ask/size arrays. One clock
+// read per batch instead of one per tick.
+struct TickBatch {
+    std::vector<SymbolId> symbol;
+    std::vector<double> bid_price;
+    std::vector<double> ask_price;
+    std::vector<int> bid_size;
+    std::vector<int> ask_size;
+    std::chrono::high_resolution_clock::time_point timestamp;
+
+    size_t size() const { return bid_price.size(); }
+    bool empty() const { return bid_price.empty(); }
+
+    void resize(size_t count) {
+        symbol.resize(count);
+        bid_price.resize(count);
+        ask_price.resize(count);
+        bid_size.resize(count);
+        ask_size.resize(count);
+    }
+
+    // Row view of tick i
+    MarketData at(size_t i) const {
+        MarketData tick;
+        tick.symbol = symbol[i];
+        tick.bid_price = bid_price[i];
+        tick.ask_price = ask_price[i];
+        tick.bid_size = bid_size[i];
+        tick.ask_size = ask_size[i];
+        tick.timestamp = timestamp;
+        return tick;
+    }
+};
+
+// Lane-parallel xoshiro128+ generator. Eight independent 32-bit streams are
+// advanced together in a plain loop over lanes, which compilers turn into
+// SIMD shifts/xors/adds. Fully determined by the seed.
+class LaneRng {
+public:
+    static constexpr size_t lanes = 8;
+
+    explicit LaneRng(uint64_t seed = 1);
+
+    // Fill out[0..count) with uniform 32-bit values
+    void fill(uint32_t* out, size_t count);
+
+    // Scalar draw (served from an internal block refilled via fill())
+    uint32_t next() {
+        if (buffered == block_size) {
+            fill(block, block_size);
+            buffered = 0;
+        }
+        return block[buffered++];
+    }
+
+private:
+    static constexpr size_t block_size = 64;
+
+    alignas(32) uint32_t s0[lanes];
+    alignas(32) uint32_t s1[lanes];
+    alignas(32) uint32_t s2[lanes];
+    alignas(32) uint32_t s3[lanes];
+    uint32_t block[block_size];
+    size_t buffered = block_size;
+};
+
 // Market Data Feed Simulator
+// Every symbol follows its own random walk starting at base_price. With an
+// explicit seed the generated sequence is reproducible; without one the
+// feed seeds itself from std::random_device.
 class MarketDataFeed {
 private:
-    std::mt19937 rng;
-    std::uniform_real_distribution<double> price_dist;
-    std::uniform_int_distribution<int> size_dist;
+    LaneRng rng;
+    double base_price;
+    std::vector<double> mid_by_symbol;  // indexed by SymbolId, 0 = not started
+    std::vector<uint32_t> scratch;      // random draws for a batch (4 per tick)
+    std::vector<double> batch_mids;     // per-symbol mids while a batch is built
     
 public:
-    MarketDataFeed(double base_price = 150.0);
+    explicit MarketDataFeed(double base_price = 150.0);
+    MarketDataFeed(double base_price, uint64_t seed);
     
     // Generate simulated market data tick
-    MarketData generateTick(const std::string& symbol);
+    MarketData generateTick(SymbolId symbol);
+
+    // Convenience overload: interns the symbol on every call (not for hot loops)
+    MarketData generateTick(const std::string& symbol) { return generateTick(internSymbol(symbol)); }
     
     // Generate multiple ticks
-    std::vector<MarketData> generateTicks(const std::string& symbol, int count);
+    std::vector<MarketData> generateTicks(SymbolId symbol, int count);
+
+    // Generate `count` ticks into `out` (resized), cycling through the
+    // distinct `symbols` round robin; each walk continues where it left off
+    void generateBatch(const SymbolId* symbols, size_t num_symbols, size_t count, TickBatch& out);
+
+    void generateBatch(SymbolId symbol, size_t count, TickBatch& out) {
+        generateBatch(&symbol, 1, count, out);
+    }
+
+    // Current mid of a symbol's walk (base price if it has not ticked yet)
+    double getMid(SymbolId symbol) const {
+        return (symbol < mid_by_symbol.size() && mid_by_symbol[symbol] > 0.0)
+            ? mid_by_symbol[symbol] : base_price;
+    }
+
+private:
+    double& midFor(SymbolId symbol) {
+        if (symbol >= mid_by_symbol.size()) mid_by_symbol.resize(symbol + 1, 0.0);
+        double& mid = mid_by_symbol[symbol];
+        if (mid <= 0.0) mid = base_price;
+        return mid;
+    }
 };
@@ -1,195 +1,378 @@
 #pragma once
 #include "Order.hpp"
 #include "OrderBook.hpp"
+#include "TraceZone.hpp"
 #include <vector>
 #include <memory>
 #include <chrono>
-
-// Trade structure to record matched trades
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <cassert>
+
+namespace engine_detail {
+
+// Hint the next cache lines the matching loop will touch (no-op elsewhere)
+inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 1, 3);
+#else
+    (void)address;
+#endif
+}
+
+// Wall-clock trade timestamp in nanoseconds (high_resolution_clock epoch)
+inline int64_t tradeTimestampNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace engine_detail
+
+// Matched trade. Trivially copyable and, for 32-bit order ids, exactly 32
+// bytes aligned to 32, so it never straddles a cache line and can be
+// memcpy'd into rings and log buffers. Fields are ordered so the 4-byte
+// members pair up ahead of the 8-byte ones without padding.
 template <typename PriceType, typename OrderIdType>
-struct Trade {
+struct alignas(32) Trade {
     OrderIdType buy_order_id;
     OrderIdType sell_order_id;
-    std::string symbol;
-    PriceType price;
+    SymbolId symbol;
     int quantity;
-    std::chrono::high_resolution_clock::time_point timestamp;
+    PriceType price;
+    int64_t timestamp_ns;  // see engine_detail::tradeTimestampNs
+
+    // Trivial, so trades can sit in preallocated rings
+    Trade() = default;
+
+    Trade(OrderIdType buy_id, OrderIdType sell_id, SymbolId sym,
+          PriceType pr, int qty, int64_t time_ns)
+        : buy_order_id(buy_id), sell_order_id(sell_id),
+          symbol(sym), quantity(qty), price(pr), timestamp_ns(time_ns) {}
+};
+
+static_assert(std::is_trivially_copyable<Trade<double, int>>::value, "Trade must stay trivially copyable");
+static_assert(sizeof(Trade<double, int>) == 32, "Trade<double, int> must fit half a cache line");
+static_assert(sizeof(Trade<int64_t, int>) == 32, "Trade<int64_t, int> must fit half a cache line");
+
+// Fixed-capacity trade sink for the allocation-free matchOrder overload.
+// Storage is allocated once up front and never grows. The engine has
+// already filled the resting orders by the time a trade reaches the sink,
+// so a dropped trade is lost for good: size the buffer for the largest
+// sweep between clear() calls (each fill takes at least one unit of the
+// incoming quantity). Overflow asserts; with NDEBUG it is counted in
+// droppedCount(), which callers must keep at zero.
+template <typename TradeType>
+class FixedTradeBuffer {
+private:
+    std::vector<TradeType> storage;
+    size_t dropped;
+
+public:
+    explicit FixedTradeBuffer(size_t capacity = 256) : dropped(0) {
+        storage.reserve(capacity);
+    }
+
+    void operator()(const TradeType& trade) {
+        assert(storage.size() < storage.capacity() && "FixedTradeBuffer overflow: fill dropped");
+        if (storage.size() < storage.capacity()) {
+            storage.push_back(trade);
+        } else {
+            ++dropped;
+        }
+    }
 
-    Trade(OrderIdType buy_id, OrderIdType sell_id, std::string sym, 
-          PriceType pr, int qty)
-        : buy_order_id(buy_id), sell_order_id(sell_id), 
-          symbol(std::move(sym)), price(pr), quantity(qty),
-          timestamp(std::chrono::high_resolution_clock::now()) {}
+    // Empties the buffer but keeps its storage
+    void clear() {
+        storage.clear();
+        dropped = 0;
+    }
+
+    typename std::vector<TradeType>::const_iterator begin() const { return storage.begin(); }
+    typename std::vector<TradeType>::const_iterator end() const { return storage.end(); }
+    const TradeType& operator[](size_t i) const { return storage[i]; }
+    size_t size() const { return storage.size(); }
+    bool empty() const { return storage.empty(); }
+    size_t capacity() const { return storage.capacity(); }
+    size_t droppedCount() const { return dropped; }
 };
 
 // High-performance matching engine
-template <typename PriceType, typename OrderIdType>
+// BookType can be swapped (e.g. MapOrderBook) for benchmarking book layouts
+template <typename PriceType, typename OrderIdType,
+          typename BookType = OrderBook<PriceType, OrderIdType>>
 class MatchingEngine {
 public:
     using OrderType = Order<PriceType, OrderIdType>;
-    using OrderPtr = std::unique_ptr<OrderType>;
+    using OrderPtr = typename BookType::OrderPtr;
     using TradeType = Trade<PriceType, OrderIdType>;
-    using OrderBookType = OrderBook<PriceType, OrderIdType>;
+    using OrderBookType = BookType;
 
 private:
     OrderBookType& order_book;
     std::vector<TradeType> trades;
+    bool record_history;
 
 public:
-    explicit MatchingEngine(OrderBookType& book) : order_book(book) {
-        trades.reserve(10000); // Pre-allocate for performance
+    // record_history = false skips the internal trade history (getTrades())
+    explicit MatchingEngine(OrderBookType& book, bool history = true)
+        : order_book(book), record_history(history) {
+        if (record_history) {
+            trades.reserve(10000); // Pre-allocate for performance
+        }
     }
 
     // Match a single order against the book
     std::vector<TradeType> matchOrder(OrderPtr order) {
+        HFT_TRACE_ZONE("MatchingEngine::matchOrder");
         std::vector<TradeType> matched_trades;
         
         if (!order) return matched_trades;
 
+        order_book.clearDepthUpdates();
+        auto collect = [&matched_trades](const TradeType& trade) { matched_trades.push_back(trade); };
         if (order->is_buy) {
             // Match buy order against sell orders
-            matchBuyOrder(std::move(order), matched_trades);
+            matchBuyOrder(std::move(order), collect);
         } else {
             // Match sell order against buy orders
-            matchSellOrder(std::move(order), matched_trades);
+            matchSellOrder(std::move(order), collect);
         }
 
         // Add to global trade history
-        trades.insert(trades.end(), matched_trades.begin(), matched_trades.end());
+        if (record_history) {
+            trades.insert(trades.end(), matched_trades.begin(), matched_trades.end());
+        }
 
         return matched_trades;
     }
 
+    // Allocation-free variant: each fill is passed to sink(const TradeType&)
+    // as it happens (e.g. a FixedTradeBuffer or a lambda). Returns the number
+    // of fills. With history disabled the hot path makes no heap allocations.
+    // Either overload leaves this call's depth deltas in the book's
+    // getDepthUpdates() when depth is enabled.
+    template <typename Sink>
+    size_t matchOrder(OrderPtr order, Sink&& sink) {
+        HFT_TRACE_ZONE("MatchingEngine::matchOrder");
+        if (!order) return 0;
+
+        order_book.clearDepthUpdates();
+        size_t fills = 0;
+        auto emit = [this, &sink, &fills](const TradeType& trade) {
+            if (record_history) trades.push_back(trade);
+            sink(trade);
+            ++fills;
+        };
+        if (order->is_buy) {
+            matchBuyOrder(std::move(order), emit);
+        } else {
+            matchSellOrder(std::move(order), emit);
+        }
+        return fills;
+    }
+
+    // Batch entry point for bursts: matches orders[0, count) in sequence
+    // with the same per-order semantics as matchOrder (each order sees the
+    // book left by the previous one). Fills from the whole batch go to one
+    // sink and the book's depth updates cover the whole batch. The top of
+    // book is kept in locals across the batch, so orders that cannot cross
+    // rest without entering the sweep loop, and the order objects a few
+    // slots ahead are prefetched. Consumed OrderPtrs are left null.
+    template <typename Sink>
+    size_t matchOrders(OrderPtr* orders, size_t count, Sink&& sink) {
+        static constexpr size_t prefetch_distance = 4;
+        HFT_TRACE_ZONE("MatchingEngine::matchOrders");
+
+        order_book.clearDepthUpdates();
+        size_t fills = 0;
+        auto emit = [this, &sink, &fills](const TradeType& trade) {
+            if (record_history) trades.push_back(trade);
+            sink(trade);
+            ++fills;
+        };
+
+        Quote quote = topOfBook();
+        for (size_t i = 0; i < count; ++i) {
+            if (i + prefetch_distance < count) engine_detail::prefetch(orders[i + prefetch_distance].get());
+
+            OrderPtr& order = orders[i];
+            if (!order) continue;
+
+            if (order->is_buy) {
+                if (!quote.has_ask || order->price < quote.ask) {
+                    // Cannot cross: rest it and keep the quote current
+                    if (order->quantity > 0) {
+                        if (!quote.has_bid || order->price > quote.bid) {
+                            quote.bid = order->price;
+                            quote.has_bid = true;
+                        }
+                        order_book.addBuyOrder(std::move(order));
+                    }
+                    order.reset();
+                    continue;
+                }
+                matchBuyOrder(std::move(order), emit);
+            } else {
+                if (!quote.has_bid || order->price > quote.bid) {
+                    if (order->quantity > 0) {
+                        if (!quote.has_ask || order->price < quote.ask) {
+                            quote.ask = order->price;
+                            quote.has_ask = true;
+                        }
+                        order_book.addSellOrder(std::move(order));
+                    }
+                    order.reset();
+                    continue;
+                }
+                matchSellOrder(std::move(order), emit);
+            }
+
+            // A sweep moved the touch on one or both sides
+            quote = topOfBook();
+        }
+        return fills;
+    }
+
+    template <typename Sink>
+    size_t matchOrders(std::vector<OrderPtr>& orders, Sink&& sink) {
+        return matchOrders(orders.data(), orders.size(), sink);
+    }
+
     // Continuously match orders in the book
     std::vector<TradeType> matchAll() {
         std::vector<TradeType> matched_trades;
 
+        order_book.clearDepthUpdates();
+        int64_t match_ns = 0;
         while (order_book.canMatch()) {
-            OrderPtr buy_order = order_book.popBestBuy();
-            OrderPtr sell_order = order_book.popBestSell();
-
-            if (!buy_order || !sell_order) break;
+            if (match_ns == 0) match_ns = engine_detail::tradeTimestampNs();
+            OrderType* buy_order = order_book.peekBestBuy();
+            OrderType* sell_order = order_book.peekBestSell();
 
             // Execute trade at the sell price (typically in real markets)
             PriceType trade_price = sell_order->price;
             int trade_quantity = std::min(buy_order->quantity, sell_order->quantity);
 
-            TradeType trade(buy_order->id, sell_order->id, buy_order->symbol,
-                          trade_price, trade_quantity);
-            
-            matched_trades.push_back(trade);
-
-            // Update order quantities
-            buy_order->quantity -= trade_quantity;
-            sell_order->quantity -= trade_quantity;
+            matched_trades.emplace_back(buy_order->id, sell_order->id, order_book.getSymbolId(),
+                                        trade_price, trade_quantity, match_ns);
 
-            // Re-add partially filled orders
-            if (buy_order->quantity > 0) {
-                order_book.addBuyOrder(std::move(buy_order));
-            }
-            if (sell_order->quantity > 0) {
-                order_book.addSellOrder(std::move(sell_order));
-            }
+            // Fill both resting orders in place; only fully filled ones leave the book
+            order_book.fillBestBuy(trade_quantity);
+            order_book.fillBestSell(trade_quantity);
         }
 
         // Add to global trade history
-        trades.insert(trades.end(), matched_trades.begin(), matched_trades.end());
+        if (record_history) {
+            trades.insert(trades.end(), matched_trades.begin(), matched_trades.end());
+        }
 
         return matched_trades;
     }
 
+    // Cancel a resting order in O(1); false if it is no longer in the book
+    bool cancelOrder(OrderIdType id) {
+        return order_book.cancelOrder(id);
+    }
+
+    // Change a resting order's quantity (reductions keep queue priority)
+    bool modifyOrder(OrderIdType id, int new_quantity) {
+        return order_book.modifyOrder(id, new_quantity);
+    }
+
     const std::vector<TradeType>& getTrades() const { return trades; }
     
     size_t getTradeCount() const { return trades.size(); }
 
     void clearTrades() { trades.clear(); }
 
+    void setRecordHistory(bool enabled) { record_history = enabled; }
+    bool isRecordingHistory() const { return record_history; }
+
 private:
-    void matchBuyOrder(OrderPtr buy_order, std::vector<TradeType>& matched_trades) {
-        while (buy_order && buy_order->quantity > 0) {
-            // Check if we can match
-            if (order_book.getSellOrderCount() == 0) {
-                // No sell orders, add buy order to book
-                order_book.addBuyOrder(std::move(buy_order));
-                break;
-            }
+    // Best bid/ask prices cached across a matchOrders batch
+    struct Quote {
+        PriceType bid{};
+        PriceType ask{};
+        bool has_bid = false;
+        bool has_ask = false;
+    };
+
+    Quote topOfBook() const {
+        Quote quote;
+        if (const OrderType* buy = order_book.peekBestBuy()) {
+            quote.bid = buy->price;
+            quote.has_bid = true;
+        }
+        if (const OrderType* sell = order_book.peekBestSell()) {
+            quote.ask = sell->price;
+            quote.has_ask = true;
+        }
+        return quote;
+    }
 
-            PriceType best_ask = order_book.getBestAsk();
-            
-            // Check if price matches
-            if (buy_order->price < best_ask) {
-                // Price doesn't match, add to book
-                order_book.addBuyOrder(std::move(buy_order));
-                break;
-            }
+    // Sweep the sell side in place: resting orders are only unlinked once
+    // fully filled, so partial fills keep their queue position
+    // Every fill of one incoming order is one event: the clock is read once,
+    // at the first fill, and shared by the sweep's trades
+    template <typename Emit>
+    void matchBuyOrder(OrderPtr buy_order, Emit& emit) {
+        int64_t match_ns = 0;
+        while (buy_order->quantity > 0) {
+            OrderType* sell_order = order_book.peekBestSell();
 
-            // Match with best sell order
-            OrderPtr sell_order = order_book.popBestSell();
-            if (!sell_order) {
-                order_book.addBuyOrder(std::move(buy_order));
-                break;
-            }
+            // Stop when the book is empty or the price no longer crosses
+            if (!sell_order || buy_order->price < sell_order->price) break;
+            if (match_ns == 0) match_ns = engine_detail::tradeTimestampNs();
+
+            // The next order in the level's queue is likely matched next
+            engine_detail::prefetch(sell_order->next);
 
             // Execute trade
             PriceType trade_price = sell_order->price;
             int trade_quantity = std::min(buy_order->quantity, sell_order->quantity);
 
-            TradeType trade(buy_order->id, sell_order->id, buy_order->symbol,
-                          trade_price, trade_quantity);
-            matched_trades.push_back(trade);
+            emit(TradeType(buy_order->id, sell_order->id, order_book.getSymbolId(),
+                           trade_price, trade_quantity, match_ns));
 
-            // Update quantities
             buy_order->quantity -= trade_quantity;
-            sell_order->quantity -= trade_quantity;
+            order_book.fillBestSell(trade_quantity);
+        }
 
-            // Re-add partially filled sell order
-            if (sell_order->quantity > 0) {
-                order_book.addSellOrder(std::move(sell_order));
-            }
+        // Rest any remaining quantity
+        if (buy_order->quantity > 0) {
+            order_book.addBuyOrder(std::move(buy_order));
         }
     }
 
-    void matchSellOrder(OrderPtr sell_order, std::vector<TradeType>& matched_trades) {
-        while (sell_order && sell_order->quantity > 0) {
-            // Check if we can match
-            if (order_book.getBuyOrderCount() == 0) {
-                // No buy orders, add sell order to book
-                order_book.addSellOrder(std::move(sell_order));
-                break;
-            }
+    // Sweep the buy side in place (mirror of matchBuyOrder)
+    template <typename Emit>
+    void matchSellOrder(OrderPtr sell_order, Emit& emit) {
+        int64_t match_ns = 0;
+        while (sell_order->quantity > 0) {
+            OrderType* buy_order = order_book.peekBestBuy();
 
-            PriceType best_bid = order_book.getBestBid();
-            
-            // Check if price matches
-            if (sell_order->price > best_bid) {
-                // Price doesn't match, add to book
-                order_book.addSellOrder(std::move(sell_order));
-                break;
-            }
+            // Stop when the book is empty or the price no longer crosses
+            if (!buy_order || sell_order->price > buy_order->price) break;
+            if (match_ns == 0) match_ns = engine_detail::tradeTimestampNs();
 
-            // Match with best buy order
-            OrderPtr buy_order = order_book.popBestBuy();
-            if (!buy_order) {
-                order_book.addSellOrder(std::move(sell_order));
-                break;
-            }
+            // The next order in the level's queue is likely matched next
+            engine_detail::prefetch(buy_order->next);
 
             // Execute trade
             PriceType trade_price = sell_order->price;
             int trade_quantity = std::min(buy_order->quantity, sell_order->quantity);
 
-            TradeType trade(buy_order->id, sell_order->id, buy_order->symbol,
-                          trade_price, trade_quantity);
-            matched_trades.push_back(trade);
+            emit(TradeType(buy_order->id, sell_order->id, order_book.getSymbolId(),
+                           trade_price, trade_quantity, match_ns));
 
-            // Update quantities
-            buy_order->quantity -= trade_quantity;
             sell_order->quantity -= trade_quantity;
+            order_book.fillBestBuy(trade_quantity);
+        }
 
-            // Re-add partially filled buy order
-            if (buy_order->quantity > 0) {
-                order_book.addBuyOrder(std::move(buy_order));
-            }
+        // Rest any remaining quantity
+        if (sell_order->quantity > 0) {
+            order_book.addSellOrder(std::move(sell_order));
         }
     }
 };
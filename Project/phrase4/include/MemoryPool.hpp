@@ -0,0 +1,198 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Memory pool allocator for performance optimization
+template<typename T>
+class MemoryPool {
+private:
+    std::vector<std::unique_ptr<T[]>> blocks;
+    std::vector<T*> free_list;
+    size_t block_size;
+    size_t current_block_index;
+    size_t current_offset;
+
+public:
+    explicit MemoryPool(size_t block_sz = 1024) 
+        : block_size(block_sz), current_block_index(0), current_offset(0) {
+        allocate_block();
+    }
+
+    T* allocate() {
+        if (!free_list.empty()) {
+            T* ptr = free_list.back();
+            free_list.pop_back();
+            return ptr;
+        }
+
+        if (current_offset >= block_size) {
+            allocate_block();
+        }
+
+        return &blocks[current_block_index][current_offset++];
+    }
+
+    void deallocate(T* ptr) {
+        free_list.push_back(ptr);
+    }
+
+    // Pre-size the pool so that up to `count` live objects never hit the
+    // system allocator. free_list is sized for the final capacity(), not
+    // just the new blocks: once every object (including ones live before
+    // this call) is returned, deallocate() must not reallocate it.
+    void reserve(size_t count) {
+        if (capacity() >= count) return;
+        size_t new_blocks = (count - capacity() + block_size - 1) / block_size;
+        free_list.reserve(capacity() + new_blocks * block_size);
+        while (capacity() < count) {
+            blocks.push_back(std::make_unique<T[]>(block_size));
+
+            // Hand out the new block front to back, after the current block
+            T* block = blocks.back().get();
+            for (size_t i = block_size; i > 0; --i) {
+                free_list.push_back(&block[i - 1]);
+            }
+        }
+    }
+
+    size_t capacity() const { return blocks.size() * block_size; }
+
+private:
+    void allocate_block() {
+        blocks.push_back(std::make_unique<T[]>(block_size));
+        current_block_index = blocks.size() - 1;
+        current_offset = 0;
+        // Grow geometrically: reserving exactly capacity() on every block
+        // would copy the whole free list each time
+        if (free_list.capacity() < capacity()) {
+            free_list.reserve(std::max(capacity(), free_list.capacity() * 2));
+        }
+    }
+};
+
+// unique_ptr deleter that returns objects to their MemoryPool.
+// A default-constructed deleter (no pool) falls back to plain delete.
+template<typename T>
+struct PoolDeleter {
+    MemoryPool<T>* pool = nullptr;
+
+    void operator()(T* ptr) const {
+        if (pool) {
+            pool->deallocate(ptr);
+        } else {
+            delete ptr;
+        }
+    }
+
+    bool operator==(const PoolDeleter& other) const { return pool == other.pool; }
+};
+
+// Raw fixed-size node pool for container nodes (e.g. std::map levels).
+// Nodes are carved from large blocks and recycled through an intrusive free
+// list. The first single-object allocation fixes the node size; arrays and
+// anything larger than a node go straight to the heap.
+class NodePool {
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    FreeNode* free_head = nullptr;
+    size_t node_size = 0;
+    size_t block_bytes;
+    size_t block_offset;
+
+public:
+    explicit NodePool(size_t block_sz = 64 * 1024) : block_bytes(block_sz), block_offset(block_sz) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    void* allocate(size_t bytes, bool single) {
+        if (single && node_size == 0) {
+            // Round up so every node in a block stays max-aligned
+            const size_t align = alignof(std::max_align_t);
+            node_size = (std::max(bytes, sizeof(FreeNode)) + align - 1) / align * align;
+        }
+        if (!single || bytes > node_size) return ::operator new(bytes);
+
+        if (free_head) {
+            FreeNode* node = free_head;
+            free_head = node->next;
+            return node;
+        }
+        if (block_offset + node_size > block_bytes) {
+            blocks.emplace_back(new char[block_bytes]);
+            block_offset = 0;
+        }
+        void* node = blocks.back().get() + block_offset;
+        block_offset += node_size;
+        return node;
+    }
+
+    void deallocate(void* ptr, size_t bytes, bool single) {
+        if (!single || bytes > node_size) {
+            ::operator delete(ptr);
+            return;
+        }
+        FreeNode* node = static_cast<FreeNode*>(ptr);
+        node->next = free_head;
+        free_head = node;
+    }
+};
+
+// Standard allocator over a NodePool (the pool must outlive the container)
+template <typename T>
+class PoolAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "NodePool nodes are max_align_t aligned");
+
+public:
+    using value_type = T;
+
+    explicit PoolAllocator(NodePool& node_pool) noexcept : pool(&node_pool) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool(other.pool) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(pool->allocate(n * sizeof(T), n == 1)); }
+    void deallocate(T* ptr, size_t n) noexcept { pool->deallocate(ptr, n * sizeof(T), n == 1); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return pool == other.pool; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const { return pool != other.pool; }
+
+    NodePool* pool;
+};
+
+// Allocation policies for OrderBook level storage. Each owns an Arena (one
+// per book, shared by both sides) and hands out allocators bound to it.
+
+// Plain std::allocator: every tree level node comes from the heap
+struct HeapAllocation {
+    struct Arena {};
+
+    template <typename T>
+    using Allocator = std::allocator<T>;
+
+    template <typename T>
+    static Allocator<T> allocator(Arena&) { return Allocator<T>(); }
+};
+
+// Tree level nodes recycled through the book's NodePool, so levels that
+// appear and vanish at the touch stop hitting malloc/free. Array-backed
+// layouts (sorted vector, ladder) only make array allocations, which the
+// pool passes through to the heap.
+struct PooledAllocation {
+    using Arena = NodePool;
+
+    template <typename T>
+    using Allocator = PoolAllocator<T>;
+
+    template <typename T>
+    static Allocator<T> allocator(Arena& arena) { return Allocator<T>(arena); }
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free multi-producer/single-consumer ring buffer (Vyukov's
+// bounded queue with the consumer side simplified for a single reader).
+// Capacity is rounded up to a power of two. Every cell carries its own
+// sequence counter on its own cache line: producers claim a position with
+// one CAS on the shared tail, fill the cell, then publish it by bumping
+// the cell's sequence, so producers never wait on each other's writes and
+// the consumer never touches the tail.
+template <typename T>
+class MpscQueue {
+private:
+    static constexpr size_t cache_line = 64;
+
+    struct alignas(cache_line) Cell {
+        std::atomic<size_t> sequence;  // == position: free, == position + 1: full
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    alignas(cache_line) std::atomic<size_t> tail{0};  // next position to claim (producers)
+    alignas(cache_line) std::atomic<size_t> head{0};  // next position to read (consumer)
+
+public:
+    explicit MpscQueue(size_t capacity = 1024) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+        mask = size - 1;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producer side (any thread): claim a cell and write it in place with
+    // fill(T& slot, size_t position). Positions are unique and increase in
+    // publication order, so callers can derive sequence numbers from them.
+    // Returns false when the ring is full.
+    template <typename Fill>
+    bool tryEmplace(Fill&& fill) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;  // the consumer hasn't freed this cell yet
+            } else {
+                pos = tail.load(std::memory_order_relaxed);  // another producer took it
+            }
+        }
+        fill(cell->data, pos);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& item) {
+        return tryEmplace([&item](T& slot, size_t) { slot = item; });
+    }
+
+    // Consumer side (one thread): returns false when the ring is empty or
+    // the next cell is claimed but not yet published
+    bool tryPop(T& item) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        Cell& cell = cells[h & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != h + 1) return false;
+        item = std::move(cell.data);
+        cell.sequence.store(h + mask + 1, std::memory_order_release);
+        head.store(h + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate when called concurrently with push/pop
+    size_t size() const {
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        return t > h ? t - h : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return mask + 1; }
+};
@@ -2,27 +2,45 @@
 #include <string>
 #include <memory>
 #include <type_traits>
+#include <cstdint>
+#include <cassert>
+#include "MemoryPool.hpp"
+#include "Symbol.hpp"
 
+// The book's node for one order: only the fields matching and the level
+// queue touch. Cold per-order data (symbol, creation / update times,
+// original quantity, state) lives in OrderManager's OrderInfo slab, indexed
+// by id, and every order resting in a book has that book's symbol.
+//
+// Side and quantity share one 32-bit word, so with 32-bit ids an order is
+// 32 bytes: two per cache line, and no node straddles a line boundary.
+// Quantities are limited to max_quantity (2^30 - 1); OrderManager and
+// OrderBook reject anything larger rather than let the bit-field wrap.
 template <typename PriceType, typename OrderIdType>
 struct Order {
     // Compile-time check: OrderIdType must be integral
     static_assert(std::is_integral<OrderIdType>::value, "Order ID must be an integer");
     static_assert(std::is_arithmetic<PriceType>::value, "Price must be an arithmetic type");
 
-    OrderIdType id;
-    std::string symbol;
     PriceType price;
-    int quantity;
-    bool is_buy;
-    std::chrono::high_resolution_clock::time_point timestamp;
+
+    // Intrusive FIFO links, only meaningful while the order rests in an OrderBook
+    Order* prev = nullptr;
+    Order* next = nullptr;
+
+    static constexpr int max_quantity = (1 << 30) - 1;
+
+    OrderIdType id;
+    int quantity : 31;  // up to max_quantity
+    bool is_buy : 1;
 
     // Default constructor (needed for memory pool)
-    Order() : id(0), symbol(""), price(0), quantity(0), is_buy(false),
-              timestamp(std::chrono::high_resolution_clock::now()) {}
+    Order() : price(0), id(0), quantity(0), is_buy(false) {}
 
-    Order(OrderIdType id, std::string sym, PriceType pr, int qty, bool buy)
-        : id(id), symbol(std::move(sym)), price(pr), quantity(qty), is_buy(buy),
-          timestamp(std::chrono::high_resolution_clock::now()) {}
+    Order(OrderIdType id, PriceType pr, int qty, bool buy)
+        : price(pr), id(id), quantity(qty), is_buy(buy) {
+        assert(qty <= max_quantity && "quantity does not fit Order::quantity");
+    }
 
     // Copy constructor
     Order(const Order& other) = default;
@@ -36,3 +54,19 @@ struct Order {
 
     ~Order() = default;
 };
+
+// MSVC starts a new allocation unit for the bool bit-field, so the layout
+// check is for GCC / Clang
+#if !defined(_MSC_VER)
+static_assert(sizeof(Order<double, int>) == 32, "Order<double, int> must fit half a cache line");
+static_assert(sizeof(Order<int64_t, int>) == 32, "Order<int64_t, int> must fit half a cache line");
+#endif
+
+// Shared pool of order objects (see OrderManager)
+template <typename PriceType, typename OrderIdType>
+using OrderPool = MemoryPool<Order<PriceType, OrderIdType>>;
+
+// Owning order pointer; pooled orders go back to their pool on release
+template <typename PriceType, typename OrderIdType>
+using UniqueOrderPtr = std::unique_ptr<Order<PriceType, OrderIdType>,
+                                       PoolDeleter<Order<PriceType, OrderIdType>>>;
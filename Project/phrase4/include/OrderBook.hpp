@@ -1,91 +1,270 @@
 #pragma once
 #include "Order.hpp"
+#include "PriceLevel.hpp"
+#include "PriceLadder.hpp"
+#include "SortedLevels.hpp"
+#include "MemoryPool.hpp"
+#include "OrderIndex.hpp"
+#include "BookDepth.hpp"
+#include "TraceZone.hpp"
 #include <map>
 #include <memory>
 #include <vector>
-#include <algorithm>
+#include <string>
+#include <functional>
+#include <iterator>
+#include <cstdint>
+#include <type_traits>
+#include <cassert>
+
+// One side of the book: explicit price levels kept in priority order
+// (best price first). Each level owns an intrusive FIFO of its orders,
+// so resting an order costs at most one tree node per distinct price.
+// AllocPolicy supplies the allocator for those tree nodes.
+template <typename PriceType, typename OrderType, typename Compare, typename AllocPolicy = HeapAllocation>
+class BookSide {
+public:
+    using LevelType = PriceLevel<OrderType>;
 
-// Memory pool allocator for performance optimization
-template<typename T>
-class MemoryPool {
 private:
-    std::vector<std::unique_ptr<T[]>> blocks;
-    std::vector<T*> free_list;
-    size_t block_size;
-    size_t current_block_index;
-    size_t current_offset;
+    using Entry = std::pair<const PriceType, LevelType>;
+
+    std::map<PriceType, LevelType, Compare, typename AllocPolicy::template Allocator<Entry>> levels;
+    size_t order_count = 0;
 
 public:
-    explicit MemoryPool(size_t block_sz = 1024) 
-        : block_size(block_sz), current_block_index(0), current_offset(0) {
-        allocate_block();
+    explicit BookSide(typename AllocPolicy::Arena& arena)
+        : levels(Compare(), AllocPolicy::template allocator<Entry>(arena)) {}
+
+    void add(OrderType* order) {
+        levels[order->price].pushBack(order);
+        ++order_count;
     }
 
-    T* allocate() {
-        if (!free_list.empty()) {
-            T* ptr = free_list.back();
-            free_list.pop_back();
-            return ptr;
+    // Append an order that sorts at or after every resting one (bulk load
+    // in priority order): the level insert is an end-hinted O(1) instead of
+    // a tree search. Out-of-order input is still placed correctly.
+    void addBack(OrderType* order) {
+        auto it = levels.end();
+        if (levels.empty() || std::prev(it)->first != order->price) {
+            it = levels.emplace_hint(it, order->price, LevelType{});
+        } else {
+            --it;
         }
+        it->second.pushBack(order);
+        ++order_count;
+    }
+
+    bool empty() const { return order_count == 0; }
+
+    // Best price on this side (caller checks empty() first)
+    PriceType bestPrice() const { return levels.begin()->first; }
 
-        if (current_offset >= block_size) {
-            allocate_block();
+    // Remove and return the oldest order at the best price
+    OrderType* popFront() {
+        if (levels.empty()) return nullptr;
+
+        auto it = levels.begin();
+        OrderType* order = it->second.popFront();
+        if (it->second.empty()) {
+            levels.erase(it);
         }
+        --order_count;
+        return order;
+    }
 
-        return &blocks[current_block_index][current_offset++];
+    // Oldest order at the best price, left in place (nullptr if empty)
+    OrderType* front() const {
+        return levels.empty() ? nullptr : levels.begin()->second.head;
     }
 
-    void deallocate(T* ptr) {
-        free_list.push_back(ptr);
+    // Fill quantity against the front order in place. The order keeps its
+    // queue position while it has quantity left; once fully filled it is
+    // unlinked and returned so the caller can release it.
+    OrderType* fillFront(int quantity) {
+        auto it = levels.begin();
+        LevelType& level = it->second;
+        level.head->quantity -= quantity;
+        level.total_quantity -= quantity;
+        if (level.head->quantity > 0) return nullptr;
+
+        OrderType* order = level.popFront();
+        if (level.empty()) {
+            levels.erase(it);
+        }
+        --order_count;
+        return order;
     }
 
-private:
-    void allocate_block() {
-        blocks.push_back(std::make_unique<T[]>(block_size));
-        current_block_index = blocks.size() - 1;
-        current_offset = 0;
+    // Unlink a resting order from its level (level lookup is O(log levels))
+    void remove(OrderType* order) {
+        auto it = levels.find(order->price);
+        it->second.unlink(order);
+        if (it->second.empty()) {
+            levels.erase(it);
+        }
+        --order_count;
+    }
+
+    // Reduce a resting order's quantity in place, keeping time priority
+    void reduce(OrderType* order, int quantity) {
+        levels.find(order->price)->second.reduce(order, quantity);
+    }
+
+    const LevelType* findLevel(PriceType price) const {
+        auto it = levels.find(price);
+        return (it != levels.end()) ? &it->second : nullptr;
+    }
+
+    // Level at the best price (nullptr if empty)
+    const LevelType* bestLevel() const {
+        return levels.empty() ? nullptr : &levels.begin()->second;
     }
+
+    // Next level after price in priority order (nullptr if none)
+    const LevelType* levelAfter(PriceType price, PriceType& next_price) const {
+        auto it = levels.upper_bound(price);
+        if (it == levels.end()) return nullptr;
+        next_price = it->first;
+        return &it->second;
+    }
+
+    // Visit up to max_count levels in priority order as (price, level)
+    template <typename Visitor>
+    void forEachLevel(size_t max_count, Visitor&& visit) const {
+        size_t visited = 0;
+        for (auto it = levels.begin(); it != levels.end() && visited++ < max_count; ++it) {
+            visit(it->first, it->second);
+        }
+    }
+
+    // Visit up to max_orders orders in priority order (price, then time)
+    template <typename Visitor>
+    void forEachOrder(size_t max_orders, Visitor&& visit) const {
+        size_t visited = 0;
+        for (const auto& entry : levels) {
+            for (const OrderType* order = entry.second.head; order; order = order->next) {
+                if (visited++ == max_orders) return;
+                visit(order);
+            }
+        }
+    }
+
+    size_t orderCount() const { return order_count; }
+    size_t levelCount() const { return levels.size(); }
+};
+
+// Level container policies: how each side of an OrderBook stores its price
+// levels. Every side type has the same interface (add, front, fillFront,
+// remove, findLevel, forEachLevel, ...), so the book, MatchingEngine and
+// the snapshot code work unchanged with any of them.
+
+// std::map of levels: any ordered price type, O(log L) level lookup
+struct TreeLevels {
+    template <typename PriceType, typename OrderType, typename Compare, typename AllocPolicy>
+    using Side = BookSide<PriceType, OrderType, Compare, AllocPolicy>;
+};
+
+// Sorted array of levels, best at the back: cheap near the touch
+struct SortedVectorLevels {
+    template <typename PriceType, typename OrderType, typename Compare, typename AllocPolicy>
+    using Side = SortedVectorSide<PriceType, OrderType, Compare, AllocPolicy>;
 };
 
-// Template-based Order Book
-template <typename PriceType, typename OrderIdType>
+// Direct-indexed price ladder: integral (tick) prices only
+struct LadderLevels {
+    template <typename PriceType, typename OrderType, typename Compare, typename AllocPolicy>
+    using Side = LadderSide<PriceType, OrderType, Compare, AllocPolicy>;
+};
+
+// Default: ladder for integral prices, tree for floating-point prices
+struct AutoLevels {
+    template <typename PriceType, typename OrderType, typename Compare, typename AllocPolicy>
+    using Side = typename std::conditional<std::is_integral<PriceType>::value,
+                                           LadderSide<PriceType, OrderType, Compare, AllocPolicy>,
+                                           BookSide<PriceType, OrderType, Compare, AllocPolicy>>::type;
+};
+
+// Template-based Order Book built from aggregated price levels.
+// LevelPolicy (TreeLevels, SortedVectorLevels, LadderLevels, AutoLevels)
+// picks the level container and AllocPolicy (HeapAllocation,
+// PooledAllocation) where its storage comes from, so layouts can be
+// swapped at compile time.
+template <typename PriceType, typename OrderIdType,
+          typename LevelPolicy = AutoLevels, typename AllocPolicy = HeapAllocation>
 class OrderBook {
 public:
     using OrderType = Order<PriceType, OrderIdType>;
-    using OrderPtr = std::unique_ptr<OrderType>;
+    using OrderPtr = UniqueOrderPtr<PriceType, OrderIdType>;
+    using LevelType = PriceLevel<OrderType>;
+    using DepthType = BookDepth<PriceType>;
+    using DepthUpdateType = DepthUpdate<PriceType>;
 
 private:
-    // Buy orders: higher price has priority (max heap behavior)
-    // Use greater for descending order
-    std::multimap<PriceType, OrderPtr, std::greater<PriceType>> buy_orders;
-    
-    // Sell orders: lower price has priority (min heap behavior)
-    std::multimap<PriceType, OrderPtr, std::less<PriceType>> sell_orders;
-    
+    template <typename Compare>
+    using SideType = typename LevelPolicy::template Side<PriceType, OrderType, Compare, AllocPolicy>;
+
+    // Level storage shared by both sides (declared first so it outlives them)
+    typename AllocPolicy::Arena level_arena;
+
+    // Buy levels: higher price has priority
+    SideType<std::greater<PriceType>> buy_side;
+
+    // Sell levels: lower price has priority
+    SideType<std::less<PriceType>> sell_side;
+
     std::string symbol;
-    MemoryPool<OrderType> memory_pool;
+    SymbolId symbol_id;
+
+    // Resting orders are stored as raw nodes; this deleter (adopted from the
+    // first OrderPtr into an empty book) hands them back to their pool. All
+    // orders resting in one book must come from the same source: an order
+    // with a different deleter is rejected (see adoptDeleter).
+    PoolDeleter<OrderType> order_deleter;
+
+    // id -> resting node, for O(1) cancel/modify
+    OrderIndex<OrderIdType, OrderType> order_index;
+
+    // Top-N aggregated levels, maintained on every level change when enabled
+    DepthType depth;
 
 public:
-    explicit OrderBook(const std::string& sym) : symbol(sym), memory_pool(1024) {}
+    explicit OrderBook(const std::string& sym)
+        : buy_side(level_arena), sell_side(level_arena), symbol(sym), symbol_id(internSymbol(sym)) {}
 
-    // Add a buy order
+    // Resting orders are held as raw intrusive nodes, so release them here
+    ~OrderBook() { clear(); }
+
+    OrderBook(const OrderBook&) = delete;
+    OrderBook& operator=(const OrderBook&) = delete;
+
+    // Add a buy order. An order whose id is already resting in this book
+    // is rejected (asserts; otherwise it is freed and the book is unchanged).
     void addBuyOrder(OrderPtr order) {
-        if (order && order->is_buy) {
-            buy_orders.emplace(order->price, std::move(order));
+        HFT_TRACE_ZONE("OrderBook::addBuyOrder");
+        if (order && order->is_buy && adoptDeleter(order)) {
+            PriceType price = order->price;
+            if (!rest(buy_side, order.get(), false)) return;
+            order.release();
+            updateDepth(buy_side, true, price);
         }
     }
 
-    // Add a sell order
+    // Add a sell order (same rules as addBuyOrder)
     void addSellOrder(OrderPtr order) {
-        if (order && !order->is_buy) {
-            sell_orders.emplace(order->price, std::move(order));
+        HFT_TRACE_ZONE("OrderBook::addSellOrder");
+        if (order && !order->is_buy && adoptDeleter(order)) {
+            PriceType price = order->price;
+            if (!rest(sell_side, order.get(), false)) return;
+            order.release();
+            updateDepth(sell_side, false, price);
         }
     }
 
     // Add order (automatically determines buy/sell)
     void addOrder(OrderPtr order) {
         if (!order) return;
-        
+
         if (order->is_buy) {
             addBuyOrder(std::move(order));
         } else {
@@ -93,21 +272,61 @@ public:
         }
     }
 
+    // Bulk load for snapshot restore: orders[0, count) per side in priority
+    // order (best level first, time order within a level), as written by
+    // forEachOrder. Levels are appended at the back of each side, the id
+    // index is sized once and the depth view is rebuilt once at the end.
+    // Consumed OrderPtrs are left null.
+    void restoreOrders(OrderPtr* orders, size_t count) {
+        static constexpr size_t prefetch_distance = 8;
+
+        order_index.reserve(order_index.size() + count);
+        for (size_t i = 0; i < count; ++i) {
+            // Index slots are scattered; start the miss for a later order now
+            if (i + prefetch_distance < count && orders[i + prefetch_distance]) {
+                order_index.prefetch(orders[i + prefetch_distance]->id);
+            }
+            OrderPtr& order = orders[i];
+            if (!order || !adoptDeleter(order)) continue;
+            bool rested = order->is_buy ? rest(buy_side, order.get(), true)
+                                        : rest(sell_side, order.get(), true);
+            if (rested) order.release();
+        }
+        if (depth.enabled()) enableDepth(depth.maxLevels());
+    }
+
+    // Visit one side's levels in priority order as (price, level)
+    template <typename Visitor>
+    void forEachLevel(bool is_buy, Visitor&& visit) const {
+        if (is_buy) {
+            buy_side.forEachLevel(SIZE_MAX, visit);
+        } else {
+            sell_side.forEachLevel(SIZE_MAX, visit);
+        }
+    }
+
+    // Visit every resting order: bids then asks, each in priority order
+    template <typename Visitor>
+    void forEachOrder(Visitor&& visit) const {
+        buy_side.forEachOrder(SIZE_MAX, visit);
+        sell_side.forEachOrder(SIZE_MAX, visit);
+    }
+
     // Get best bid (highest buy price)
     PriceType getBestBid() const {
-        if (buy_orders.empty()) return PriceType{};
-        return buy_orders.begin()->first;
+        if (buy_side.empty()) return PriceType{};
+        return buy_side.bestPrice();
     }
 
     // Get best ask (lowest sell price)
     PriceType getBestAsk() const {
-        if (sell_orders.empty()) return PriceType{};
-        return sell_orders.begin()->first;
+        if (sell_side.empty()) return PriceType{};
+        return sell_side.bestPrice();
     }
 
     // Check if orders can be matched
     bool canMatch() const {
-        if (buy_orders.empty() || sell_orders.empty()) return false;
+        if (buy_side.empty() || sell_side.empty()) return false;
         return getBestBid() >= getBestAsk();
     }
 
@@ -115,11 +334,7 @@ public:
     std::vector<const OrderType*> getTopBuyOrders(size_t count = 5) const {
         std::vector<const OrderType*> result;
         result.reserve(count);
-        
-        auto it = buy_orders.begin();
-        for (size_t i = 0; i < count && it != buy_orders.end(); ++i, ++it) {
-            result.push_back(it->second.get());
-        }
+        buy_side.forEachOrder(count, [&](const OrderType* order) { result.push_back(order); });
         return result;
     }
 
@@ -127,44 +342,237 @@ public:
     std::vector<const OrderType*> getTopSellOrders(size_t count = 5) const {
         std::vector<const OrderType*> result;
         result.reserve(count);
-        
-        auto it = sell_orders.begin();
-        for (size_t i = 0; i < count && it != sell_orders.end(); ++i, ++it) {
-            result.push_back(it->second.get());
-        }
+        sell_side.forEachOrder(count, [&](const OrderType* order) { result.push_back(order); });
         return result;
     }
 
     // Remove and return the best buy order
     OrderPtr popBestBuy() {
-        if (buy_orders.empty()) return nullptr;
-        
-        auto it = buy_orders.begin();
-        OrderPtr order = std::move(it->second);
-        buy_orders.erase(it);
+        if (!depth.enabled() || buy_side.empty()) return retire(buy_side.popFront());
+        PriceType price = buy_side.bestPrice();
+        OrderPtr order = retire(buy_side.popFront());
+        updateDepthAtBest(buy_side, true, price);
         return order;
     }
 
     // Remove and return the best sell order
     OrderPtr popBestSell() {
-        if (sell_orders.empty()) return nullptr;
-        
-        auto it = sell_orders.begin();
-        OrderPtr order = std::move(it->second);
-        sell_orders.erase(it);
+        if (!depth.enabled() || sell_side.empty()) return retire(sell_side.popFront());
+        PriceType price = sell_side.bestPrice();
+        OrderPtr order = retire(sell_side.popFront());
+        updateDepthAtBest(sell_side, false, price);
         return order;
     }
 
+    // Best resting orders, left in the book (nullptr if that side is empty)
+    OrderType* peekBestBuy() const { return buy_side.front(); }
+    OrderType* peekBestSell() const { return sell_side.front(); }
+
+    // Fill the best resting order in place; it is removed only once its
+    // quantity reaches zero, so partial fills keep time priority
+    void fillBestBuy(int quantity) {
+        if (!depth.enabled()) {
+            retire(buy_side.fillFront(quantity));
+            return;
+        }
+        PriceType price = buy_side.bestPrice();
+        retire(buy_side.fillFront(quantity));
+        updateDepthAtBest(buy_side, true, price);
+    }
+
+    void fillBestSell(int quantity) {
+        if (!depth.enabled()) {
+            retire(sell_side.fillFront(quantity));
+            return;
+        }
+        PriceType price = sell_side.bestPrice();
+        retire(sell_side.fillFront(quantity));
+        updateDepthAtBest(sell_side, false, price);
+    }
+
+    // Cancel a resting order: index lookup plus an intrusive unlink.
+    // Returns false if the id is not resting (already filled or unknown).
+    bool cancelOrder(OrderIdType id) {
+        HFT_TRACE_ZONE("OrderBook::cancelOrder");
+        OrderType* order = order_index.find(id);
+        if (!order) return false;
+
+        PriceType price = order->price;
+        bool is_buy = order->is_buy;
+        if (is_buy) {
+            buy_side.remove(order);
+        } else {
+            sell_side.remove(order);
+        }
+        retire(order);
+
+        if (is_buy) {
+            updateDepth(buy_side, true, price);
+        } else {
+            updateDepth(sell_side, false, price);
+        }
+        return true;
+    }
+
+    // Change a resting order's quantity. Reductions happen in place and keep
+    // time priority; increases re-queue the order at the back of its level.
+    // A new quantity <= 0 cancels the order; one above OrderType::max_quantity
+    // is rejected (returns false, the order is left unchanged).
+    bool modifyOrder(OrderIdType id, int new_quantity) {
+        HFT_TRACE_ZONE("OrderBook::modifyOrder");
+        if (new_quantity <= 0) return cancelOrder(id);
+        if (new_quantity > OrderType::max_quantity) return false;
+
+        OrderType* order = order_index.find(id);
+        if (!order) return false;
+
+        if (new_quantity <= order->quantity) {
+            int reduction = order->quantity - new_quantity;
+            if (order->is_buy) {
+                buy_side.reduce(order, reduction);
+            } else {
+                sell_side.reduce(order, reduction);
+            }
+        } else if (order->is_buy) {
+            buy_side.remove(order);
+            order->quantity = new_quantity;
+            buy_side.add(order);
+        } else {
+            sell_side.remove(order);
+            order->quantity = new_quantity;
+            sell_side.add(order);
+        }
+
+        if (order->is_buy) {
+            updateDepth(buy_side, true, order->price);
+        } else {
+            updateDepth(sell_side, false, order->price);
+        }
+        return true;
+    }
+
+    // Look up a resting order by id (nullptr if not in the book)
+    const OrderType* findOrder(OrderIdType id) const { return order_index.find(id); }
+
+    // Aggregated level lookup (nullptr if no orders rest at that price)
+    const LevelType* getBuyLevel(PriceType price) const { return buy_side.findLevel(price); }
+    const LevelType* getSellLevel(PriceType price) const { return sell_side.findLevel(price); }
+
     // Get statistics
-    size_t getBuyOrderCount() const { return buy_orders.size(); }
-    size_t getSellOrderCount() const { return sell_orders.size(); }
-    size_t getTotalOrderCount() const { return buy_orders.size() + sell_orders.size(); }
+    size_t getBuyOrderCount() const { return buy_side.orderCount(); }
+    size_t getSellOrderCount() const { return sell_side.orderCount(); }
+    size_t getTotalOrderCount() const { return getBuyOrderCount() + getSellOrderCount(); }
+
+    size_t getBuyLevelCount() const { return buy_side.levelCount(); }
+    size_t getSellLevelCount() const { return sell_side.levelCount(); }
+
+    // Maintain an L2 view of the top `levels` aggregated levels per side
+    // (0 turns it off). Built once from the current book, then updated
+    // incrementally on add, fill, cancel and modify.
+    void enableDepth(size_t levels) {
+        depth.configure(levels);
+        buy_side.forEachLevel(levels, [this](PriceType price, const LevelType& level) {
+            depth.refill(true, price, level.total_quantity, level.order_count);
+        });
+        sell_side.forEachLevel(levels, [this](PriceType price, const LevelType& level) {
+            depth.refill(false, price, level.total_quantity, level.order_count);
+        });
+        depth.clearUpdates();
+    }
+
+    // Allocation-free depth read: getDepth().bid(i) / ask(i), best first
+    const DepthType& getDepth() const { return depth; }
+
+    // Levels changed since the last clearDepthUpdates() (MatchingEngine
+    // clears at the start of each matchOrder)
+    const std::vector<DepthUpdateType>& getDepthUpdates() const { return depth.updates(); }
+    void clearDepthUpdates() { depth.clearUpdates(); }
 
     const std::string& getSymbol() const { return symbol; }
+    SymbolId getSymbolId() const { return symbol_id; }
 
     // Clear all orders
     void clear() {
-        buy_orders.clear();
-        sell_orders.clear();
+        while (!buy_side.empty()) reclaim(buy_side.popFront());
+        while (!sell_side.empty()) reclaim(sell_side.popFront());
+        order_index.clear();
+        depth.reset();
+    }
+
+private:
+    // The first order into an empty book sets the deleter; later ones must
+    // carry the same one (same pool, or heap), or they would be freed with
+    // the wrong one. A mismatch asserts; without asserts the order is not
+    // added and is released through its own deleter.
+    bool adoptDeleter(const OrderPtr& order) {
+        if (order_index.size() == 0) {
+            order_deleter = order.get_deleter();
+            return true;
+        }
+        bool same = order.get_deleter() == order_deleter;
+        assert(same && "orders in one book must share a pool (or all be heap orders)");
+        return same;
+    }
+
+    // Put the node on its side, then index it. The side goes first so one
+    // that throws (LadderLevels: price range past max_levels) leaves the
+    // book unchanged and the caller's OrderPtr still owns the node. A
+    // duplicate id is taken back off the side; the caller keeps ownership.
+    template <typename Side>
+    bool rest(Side& side, OrderType* order, bool at_back) {
+        if (at_back) {
+            side.addBack(order);
+        } else {
+            side.add(order);
+        }
+        if (order_index.insert(order->id, order)) return true;
+        side.remove(order);
+        assert(false && "order id is already resting in this book");
+        return false;
+    }
+
+    // Re-wrap a raw node so it goes back to its pool when the pointer is dropped
+    OrderPtr reclaim(OrderType* order) const {
+        return OrderPtr(order, order_deleter);
+    }
+
+    // An order left the book: drop it from the index and take ownership back
+    OrderPtr retire(OrderType* order) {
+        if (order) order_index.erase(order->id);
+        return reclaim(order);
+    }
+
+    // A level at this price changed: republish it if it is in the depth window
+    template <typename Side>
+    void updateDepth(const Side& side, bool is_buy, PriceType price) {
+        if (!depth.inWindow(is_buy, price)) return;
+        const LevelType* level = side.findLevel(price);
+        publishLevel(side, is_buy, price, level);
+    }
+
+    // Same for the level that was best before a fill/pop (no lookup needed)
+    template <typename Side>
+    void updateDepthAtBest(const Side& side, bool is_buy, PriceType price) {
+        const LevelType* level = (!side.empty() && side.bestPrice() == price) ? side.bestLevel() : nullptr;
+        publishLevel(side, is_buy, price, level);
+    }
+
+    template <typename Side>
+    void publishLevel(const Side& side, bool is_buy, PriceType price, const LevelType* level) {
+        bool vacated = depth.apply(is_buy, price, level ? level->total_quantity : 0,
+                                   level ? level->order_count : 0);
+        if (!vacated) return;
+
+        // A full window lost a level: pull in the next one from the book
+        PriceType last;
+        PriceType next_price{};
+        const LevelType* next = nullptr;
+        if (depth.lastPrice(is_buy, last)) {
+            next = side.levelAfter(last, next_price);
+        } else if (!side.empty()) {
+            next = side.bestLevel();
+            next_price = side.bestPrice();
+        }
+        if (next) depth.refill(is_buy, next_price, next->total_quantity, next->order_count);
     }
 };
@@ -0,0 +1,198 @@
+#pragma once
+#include "Order.hpp"
+#include "OrderBook.hpp"
+#include "MatchingEngine.hpp"
+#include "MpscQueue.hpp"
+#include "WaitStrategy.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// What an ExecutionReport describes
+enum class ExecType : uint8_t {
+    Fill,  // part or all of the order traded (sent to both sides)
+    Ack    // the order has been fully processed; leaves_quantity rests in the book
+};
+
+// Sent to a session's handler on the matching thread
+template <typename PriceType, typename OrderIdType>
+struct ExecutionReport {
+    OrderIdType order_id;          // the receiving session's order
+    OrderIdType contra_order_id;   // Fill: the other side's order
+    PriceType price;               // Fill: trade price; Ack: order price
+    int quantity;                  // Fill: traded quantity
+    int leaves_quantity;           // Ack: quantity left resting (0 if fully filled)
+    uint64_t client_tag;           // Ack: tag passed to submit()
+    ExecType type;
+    bool is_buy;                   // side of order_id
+};
+
+// Multi-threaded front end for one book. Any number of session (producer)
+// threads submit orders into a bounded lock-free MPSC ring; one matching
+// thread drains it in arrival order, runs MatchingEngine, and reports fills
+// and acks through each session's handler. Book, engine and order pool are
+// only touched by the matching thread, so matching itself stays unsynchronized.
+//
+// Handlers run on the matching thread and should hand reports off quickly.
+// WaitStrategy (SpinWait, ParkWait) decides how the matching thread idles
+// while the ring is empty.
+template <typename PriceType, typename OrderIdType,
+          typename BookType = OrderBook<PriceType, OrderIdType>,
+          typename WaitStrategy = SpinWait>
+class OrderGateway {
+public:
+    using OrderType = Order<PriceType, OrderIdType>;
+    using OrderPtr = UniqueOrderPtr<PriceType, OrderIdType>;
+    using OrderBookType = BookType;
+    using MatchingEngineType = MatchingEngine<PriceType, OrderIdType, BookType>;
+    using ReportType = ExecutionReport<PriceType, OrderIdType>;
+    using ReportHandler = std::function<void(const ReportType&)>;
+    using SessionId = uint16_t;
+
+    // Returned by submit() for a rejected request (ids start at 1)
+    static constexpr OrderIdType invalid_order_id = 0;
+
+private:
+    // Plain data, so it can cross threads; the order is built on the matching thread
+    struct Request {
+        OrderIdType id;
+        PriceType price;
+        int quantity;
+        SessionId session;
+        bool is_buy;
+        uint64_t client_tag;
+    };
+
+    MpscQueue<Request> queue;
+    WaitStrategy waiter;
+
+    // Matching-thread state. The pool is declared before the book so it
+    // outlives the orders resting there.
+    OrderPool<PriceType, OrderIdType> pool;
+    OrderBookType book;
+    MatchingEngineType engine;
+    std::vector<ReportHandler> handlers;
+    std::vector<SessionId> session_by_order;  // indexed by order id
+    uint64_t trades = 0;
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> processed{0};
+
+public:
+    explicit OrderGateway(const std::string& symbol, size_t queue_capacity = 65536,
+                          size_t expected_orders = 65536)
+        : queue(queue_capacity), pool(1024), book(symbol), engine(book, false) {
+        pool.reserve(expected_orders);
+        session_by_order.reserve(expected_orders + 1);
+    }
+
+    ~OrderGateway() { stop(); }
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    // Register a session (before start()); its handler receives the
+    // session's fills and acks
+    SessionId connect(ReportHandler handler) {
+        if (handlers.size() > UINT16_MAX) throw std::length_error("Too many gateway sessions");
+        handlers.push_back(std::move(handler));
+        return static_cast<SessionId>(handlers.size() - 1);
+    }
+
+    void start() {
+        if (running.exchange(true)) return;
+        worker = std::thread([this] { run(); });
+    }
+
+    // Drain the ring and join the matching thread
+    void stop() {
+        if (!running.exchange(false)) return;
+        waiter.wakeAll();
+        if (worker.joinable()) worker.join();
+    }
+
+    // Producer side (any thread). Ids come from the ring position, so they
+    // are unique and increase in matching order without a separate
+    // counter. Spins while the ring is full, which applies backpressure.
+    // Returns the assigned order id, or invalid_order_id without enqueueing
+    // anything for a session that was never connected or a quantity outside
+    // 1..OrderType::max_quantity (sessions are only added before start(),
+    // so the check needs no synchronization).
+    OrderIdType submit(SessionId session, PriceType price, int quantity, bool is_buy,
+                       uint64_t client_tag = 0) {
+        if (session >= handlers.size()) return invalid_order_id;
+        if (quantity <= 0 || quantity > OrderType::max_quantity) return invalid_order_id;
+
+        OrderIdType id{};
+        auto fill = [&](Request& request, size_t position) {
+            id = static_cast<OrderIdType>(position + 1);
+            request = Request{id, price, quantity, session, is_buy, client_tag};
+        };
+        while (!queue.tryEmplace(fill)) {
+            std::this_thread::yield();
+        }
+        waiter.notify();
+        return id;
+    }
+
+    size_t getSessionCount() const { return handlers.size(); }
+    size_t getQueueCapacity() const { return queue.capacity(); }
+    uint64_t getProcessedCount() const { return processed.load(std::memory_order_relaxed); }
+
+    // Only stable after stop()
+    uint64_t getTradeCount() const { return trades; }
+    const OrderBookType& getBook() const { return book; }
+
+private:
+    void run() {
+        Request request;
+        auto ready = [this] {
+            return !queue.empty() || !running.load(std::memory_order_acquire);
+        };
+        while (true) {
+            if (queue.tryPop(request)) {
+                process(request);
+                continue;
+            }
+            // Exit only once stopped and fully drained
+            if (!running.load(std::memory_order_acquire) && queue.empty()) break;
+            waiter.wait(ready);
+        }
+    }
+
+    void process(const Request& request) {
+        if (static_cast<size_t>(request.id) >= session_by_order.size()) {
+            session_by_order.resize(static_cast<size_t>(request.id) * 2 + 1);
+        }
+        session_by_order[static_cast<size_t>(request.id)] = request.session;
+
+        OrderPtr order(pool.allocate(), PoolDeleter<OrderType>{&pool});
+        *order = OrderType(request.id, request.price, request.quantity, request.is_buy);
+
+        trades += engine.matchOrder(std::move(order), [this](const auto& trade) {
+            report(trade.buy_order_id, trade.sell_order_id, true, trade);
+            report(trade.sell_order_id, trade.buy_order_id, false, trade);
+        });
+
+        const OrderType* resting = book.findOrder(request.id);
+        ReportType ack{request.id, OrderIdType{}, request.price, 0,
+                       resting ? resting->quantity : 0, request.client_tag, ExecType::Ack, request.is_buy};
+        dispatch(request.session, ack);
+        processed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename TradeType>
+    void report(OrderIdType order_id, OrderIdType contra_id, bool is_buy, const TradeType& trade) {
+        ReportType fill{order_id, contra_id, trade.price, trade.quantity, 0, 0, ExecType::Fill, is_buy};
+        dispatch(session_by_order[static_cast<size_t>(order_id)], fill);
+    }
+
+    void dispatch(SessionId session, const ReportType& report) {
+        const ReportHandler& handler = handlers[session];
+        if (handler) handler(report);
+    }
+};
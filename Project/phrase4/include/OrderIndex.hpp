@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Flat open-addressing map from order id to resting order node.
+// Linear probing with backward-shift deletion (no tombstones), so insert,
+// find and erase are O(1) on average and never allocate once reserved.
+// Grows by doubling when the load factor reaches 1/2.
+template <typename OrderIdType, typename NodeType>
+class OrderIndex {
+    static_assert(std::is_integral<OrderIdType>::value, "Order ID must be an integer");
+
+private:
+    struct Slot {
+        OrderIdType id;
+        NodeType* node;  // nullptr marks an empty slot
+    };
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+
+public:
+    explicit OrderIndex(size_t expected = 1024) { reserve(expected); }
+
+    // Make room for `expected` entries without rehashing
+    void reserve(size_t expected) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) capacity <<= 1;
+        if (capacity > slots.size()) rehash(capacity);
+    }
+
+    // Returns false, leaving the existing entry in place, if the id is
+    // already indexed
+    bool insert(OrderIdType id, NodeType* node) {
+        if ((count + 1) * 2 > slots.size()) rehash(slots.size() * 2);
+
+        size_t pos = home(id);
+        while (slots[pos].node && slots[pos].id != id) pos = (pos + 1) & mask;
+        if (slots[pos].node) return false;
+        ++count;
+        slots[pos] = {id, node};
+        return true;
+    }
+
+    // Pull the id's home slot into cache ahead of an insert (bulk loads)
+    void prefetch(OrderIdType id) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&slots[home(id)], 1, 1);
+#else
+        (void)id;
+#endif
+    }
+
+    NodeType* find(OrderIdType id) const {
+        for (size_t pos = home(id); slots[pos].node; pos = (pos + 1) & mask) {
+            if (slots[pos].id == id) return slots[pos].node;
+        }
+        return nullptr;
+    }
+
+    bool erase(OrderIdType id) {
+        size_t pos = home(id);
+        while (slots[pos].node && slots[pos].id != id) pos = (pos + 1) & mask;
+        if (!slots[pos].node) return false;
+
+        // Backward-shift the rest of the probe run into the hole
+        size_t hole = pos;
+        for (size_t next = (hole + 1) & mask; slots[next].node; next = (next + 1) & mask) {
+            size_t ideal = home(slots[next].id);
+            // Move the entry if its home is not cyclically within (hole, next]
+            if (((next - ideal) & mask) >= ((next - hole) & mask)) {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+        }
+        slots[hole].node = nullptr;
+        --count;
+        return true;
+    }
+
+    void clear() {
+        for (auto& slot : slots) slot.node = nullptr;
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+
+private:
+    size_t home(OrderIdType id) const {
+        // Fibonacci hashing spreads dense sequential ids across the table
+        uint64_t h = static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 32) & mask;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(capacity, Slot{OrderIdType{}, nullptr});
+        mask = capacity - 1;
+        count = 0;
+        for (const auto& slot : old) {
+            if (slot.node) insert(slot.id, slot.node);
+        }
+    }
+};
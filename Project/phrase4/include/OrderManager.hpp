@@ -1,8 +1,11 @@
 #pragma once
 #include "Order.hpp"
-#include <unordered_map>
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Order states for tracking
 enum class OrderState {
@@ -13,11 +16,13 @@ enum class OrderState {
     REJECTED
 };
 
-// Order info for management
+constexpr size_t order_state_count = 5;
+
+// Order info for management: the cold half of an order (see Order)
 template <typename PriceType, typename OrderIdType>
 struct OrderInfo {
     OrderIdType id;
-    std::string symbol;
+    SymbolId symbol;
     PriceType price;
     int original_quantity;
     int remaining_quantity;
@@ -26,99 +31,166 @@ struct OrderInfo {
     std::chrono::high_resolution_clock::time_point created_at;
     std::chrono::high_resolution_clock::time_point updated_at;
 
-    OrderInfo(const Order<PriceType, OrderIdType>& order)
-        : id(order.id), symbol(order.symbol), price(order.price),
-          original_quantity(order.quantity), remaining_quantity(order.quantity),
-          is_buy(order.is_buy), state(OrderState::NEW),
-          created_at(order.timestamp), updated_at(order.timestamp) {}
+    OrderInfo() = default;
+
+    OrderInfo(OrderIdType order_id, SymbolId sym, PriceType pr, int qty, bool buy,
+              std::chrono::high_resolution_clock::time_point time)
+        : id(order_id), symbol(sym), price(pr),
+          original_quantity(qty), remaining_quantity(qty),
+          is_buy(buy), state(OrderState::NEW),
+          created_at(time), updated_at(time) {}
 };
 
 // Order Management System
+//
+// Ids are handed out densely from next_order_id, so OrderInfo records live
+// in a slab indexed by id: fixed-size chunks that are never moved or
+// rehashed, appended one chunk at a time. Counters per OrderState are kept
+// up to date on every transition, so getOrdersByState() is O(1).
 template <typename PriceType, typename OrderIdType>
 class OrderManager {
+    static_assert(std::is_integral<OrderIdType>::value, "Order ID must be an integer");
+
 public:
     using OrderType = Order<PriceType, OrderIdType>;
-    using OrderPtr = std::unique_ptr<OrderType>;
+    using OrderPtr = UniqueOrderPtr<PriceType, OrderIdType>;
     using OrderInfoType = OrderInfo<PriceType, OrderIdType>;
+    using OrderPoolType = OrderPool<PriceType, OrderIdType>;
+
+    // Non-owning handle to an order's record; stays valid for the lifetime
+    // of the manager (chunks never move). nullptr for unknown ids.
+    using OrderInfoHandle = const OrderInfoType*;
 
 private:
-    std::unordered_map<OrderIdType, std::shared_ptr<OrderInfoType>> orders;
+    static constexpr size_t chunk_bits = 12;
+    static constexpr size_t chunk_size = size_t{1} << chunk_bits;  // records per chunk
+
+    std::vector<std::unique_ptr<OrderInfoType[]>> chunks;
+    size_t order_count;
+    std::array<size_t, order_state_count> state_counts;
     OrderIdType next_order_id;
+    OrderPoolType* order_pool;
 
 public:
-    OrderManager() : next_order_id(1) {}
+    // Heap-allocating manager: every order comes from the system allocator
+    OrderManager() : order_count(0), state_counts{}, next_order_id(1), order_pool(nullptr) {}
+
+    // Pooled manager: orders are taken from (and returned to) a shared pool.
+    // The pool must outlive every order created here, including those resting in books.
+    explicit OrderManager(OrderPoolType& pool)
+        : order_count(0), state_counts{}, next_order_id(1), order_pool(&pool) {}
+
+    OrderManager(const OrderManager&) = delete;
+    OrderManager& operator=(const OrderManager&) = delete;
+    OrderManager(OrderManager&&) noexcept = default;
+    OrderManager& operator=(OrderManager&&) noexcept = default;
+
+    // Pre-allocate records for `count` orders in total (keeps chunk
+    // allocation out of the hot path)
+    void reserve(size_t count) {
+        while (chunks.size() * chunk_size < count) addChunk();
+    }
 
-    // Create and register a new order
-    OrderPtr createOrder(const std::string& symbol, PriceType price, 
+    // Create and register a new order. A quantity above
+    // OrderType::max_quantity is registered as REJECTED and returns nullptr.
+    OrderPtr createOrder(SymbolId symbol, PriceType price,
                         int quantity, bool is_buy) {
         OrderIdType id = next_order_id++;
-        auto order = std::make_unique<OrderType>(id, symbol, price, quantity, is_buy);
+        bool rejected = quantity > OrderType::max_quantity;
+        OrderPtr order = rejected ? OrderPtr() : makeOrder(id, price, quantity, is_buy);
         
-        // Register the order
-        auto order_info = std::make_shared<OrderInfoType>(*order);
-        orders[id] = order_info;
+        // Register the order in the next slab slot
+        if (order_count == chunks.size() * chunk_size) addChunk();
+        OrderInfoType& info = slot(order_count);
+        info = OrderInfoType(id, symbol, price, quantity, is_buy,
+                             std::chrono::high_resolution_clock::now());
+        if (rejected) info.state = OrderState::REJECTED;
+        ++order_count;
+        ++state_counts[static_cast<size_t>(info.state)];
 
         return order;
     }
 
+    // Convenience overload: interns the symbol on every call (not for hot loops)
+    OrderPtr createOrder(const std::string& symbol, PriceType price,
+                        int quantity, bool is_buy) {
+        return createOrder(internSymbol(symbol), price, quantity, is_buy);
+    }
+
+    // Snapshot restore: re-register a saved record. Records must arrive in
+    // id order starting at 1 (ids stay dense) with a valid state; returns
+    // false otherwise.
+    bool restoreOrderInfo(const OrderInfoType& info) {
+        if (static_cast<size_t>(info.id) != order_count + 1) return false;
+        if (static_cast<size_t>(info.state) >= order_state_count) return false;
+
+        if (order_count == chunks.size() * chunk_size) addChunk();
+        slot(order_count) = info;
+        ++order_count;
+        ++state_counts[static_cast<size_t>(info.state)];
+        next_order_id = static_cast<OrderIdType>(order_count + 1);
+        return true;
+    }
+
+    // Order object for a restored resting order: same id, allocated like
+    // createOrder but not registered again (its record comes from the
+    // snapshot too)
+    OrderPtr rebuildOrder(OrderIdType id, PriceType price, int quantity, bool is_buy) {
+        return makeOrder(id, price, quantity, is_buy);
+    }
+
     // Update order state
     void updateOrderState(OrderIdType id, OrderState state) {
-        auto it = orders.find(id);
-        if (it != orders.end()) {
-            it->second->state = state;
-            it->second->updated_at = std::chrono::high_resolution_clock::now();
+        if (OrderInfoType* info = find(id)) {
+            transition(*info, state);
         }
     }
 
     // Update remaining quantity (for partial fills)
     void updateRemainingQuantity(OrderIdType id, int remaining) {
-        auto it = orders.find(id);
-        if (it != orders.end()) {
-            it->second->remaining_quantity = remaining;
-            it->second->updated_at = std::chrono::high_resolution_clock::now();
+        if (OrderInfoType* info = find(id)) {
+            info->remaining_quantity = remaining;
             
             // Update state based on remaining quantity
             if (remaining == 0) {
-                it->second->state = OrderState::FILLED;
-            } else if (remaining < it->second->original_quantity) {
-                it->second->state = OrderState::PARTIAL_FILLED;
+                transition(*info, OrderState::FILLED);
+            } else if (remaining < info->original_quantity) {
+                transition(*info, OrderState::PARTIAL_FILLED);
+            } else {
+                info->updated_at = std::chrono::high_resolution_clock::now();
             }
         }
     }
 
-    // Cancel an order
+    // Cancel an order (state only; remove it from the book with
+    // MatchingEngine::cancelOrder)
     bool cancelOrder(OrderIdType id) {
-        auto it = orders.find(id);
-        if (it != orders.end() && it->second->state != OrderState::FILLED) {
-            it->second->state = OrderState::CANCELLED;
-            it->second->updated_at = std::chrono::high_resolution_clock::now();
+        OrderInfoType* info = find(id);
+        if (info && info->state != OrderState::FILLED) {
+            transition(*info, OrderState::CANCELLED);
             return true;
         }
         return false;
     }
 
     // Get order info
-    std::shared_ptr<OrderInfoType> getOrderInfo(OrderIdType id) const {
-        auto it = orders.find(id);
-        return (it != orders.end()) ? it->second : nullptr;
+    OrderInfoHandle getOrderInfo(OrderIdType id) const {
+        return const_cast<OrderManager*>(this)->find(id);
     }
 
-    // Get all orders
-    const std::unordered_map<OrderIdType, std::shared_ptr<OrderInfoType>>& getAllOrders() const {
-        return orders;
+    // Visit every order record in id order
+    template <typename Visitor>
+    void forEachOrder(Visitor&& visitor) const {
+        for (size_t i = 0; i < order_count; ++i) {
+            visitor(static_cast<const OrderInfoType&>(chunks[i >> chunk_bits][i & (chunk_size - 1)]));
+        }
     }
 
     // Get statistics
-    size_t getTotalOrders() const { return orders.size(); }
+    size_t getTotalOrders() const { return order_count; }
 
     size_t getOrdersByState(OrderState state) const {
-        size_t count = 0;
-        for (const auto& pair : orders) {
-            if (pair.second->state == state) {
-                ++count;
-            }
-        }
-        return count;
+        return state_counts[static_cast<size_t>(state)];
     }
 
     // Convert order state to string
@@ -132,4 +204,37 @@ public:
             default: return "UNKNOWN";
         }
     }
+
+private:
+    template <typename... Args>
+    OrderPtr makeOrder(Args... args) {
+        if (order_pool) {
+            OrderPtr order(order_pool->allocate(), PoolDeleter<OrderType>{order_pool});
+            *order = OrderType(args...);
+            return order;
+        }
+        return OrderPtr(new OrderType(args...));
+    }
+
+    OrderInfoType& slot(size_t index) {
+        return chunks[index >> chunk_bits][index & (chunk_size - 1)];
+    }
+
+    // Ids start at 1 and are dense, so the slab index is id - 1
+    OrderInfoType* find(OrderIdType id) {
+        if (id < 1) return nullptr;
+        size_t index = static_cast<size_t>(id) - 1;
+        return index < order_count ? &slot(index) : nullptr;
+    }
+
+    void transition(OrderInfoType& info, OrderState state) {
+        --state_counts[static_cast<size_t>(info.state)];
+        ++state_counts[static_cast<size_t>(state)];
+        info.state = state;
+        info.updated_at = std::chrono::high_resolution_clock::now();
+    }
+
+    void addChunk() {
+        chunks.push_back(std::make_unique<OrderInfoType[]>(chunk_size));
+    }
 };
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+
+// Fixed-point price: an integer number of ticks
+using PriceTicks = int64_t;
+
+// Per-symbol tick size for converting between decimal prices and ticks.
+// Prices are only converted at the edges (market data in, logs out);
+// books and the matching engine compare integer ticks.
+class TickSize {
+public:
+    explicit TickSize(double tick_size = 0.01)
+        : tick(tick_size), ticks_per_unit(1.0 / tick_size) {}
+
+    // Round a decimal price to the nearest tick
+    PriceTicks toTicks(double price) const {
+        return static_cast<PriceTicks>(std::llround(price * ticks_per_unit));
+    }
+
+    double toPrice(PriceTicks ticks) const {
+        return static_cast<double>(ticks) * tick;
+    }
+
+    double value() const { return tick; }
+
+private:
+    double tick;
+    double ticks_per_unit;
+};
@@ -0,0 +1,283 @@
+#pragma once
+#include "PriceLevel.hpp"
+#include "MemoryPool.hpp"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+// Bit scan helpers for the occupancy bitmap
+namespace ladder_detail {
+
+inline int highestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(word);
+#else
+    int bit = 63;
+    while (!(word & (uint64_t{1} << bit))) --bit;
+    return bit;
+#endif
+}
+
+inline int lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & (uint64_t{1} << bit))) ++bit;
+    return bit;
+#endif
+}
+
+} // namespace ladder_detail
+
+// One side of the book for integral (tick) prices: a flat array of price
+// levels indexed by (price - base), plus a bitmap of non-empty levels.
+// Level lookup and best price are O(1); when the best level empties, the
+// next one is found by scanning bitmap words (64 levels per step).
+// The ladder re-centres or doubles when a price falls outside its range.
+// AllocPolicy supplies the allocator for the level and bitmap arrays.
+template <typename PriceType, typename OrderType, typename Compare, typename AllocPolicy = HeapAllocation>
+class LadderSide {
+    static_assert(std::is_integral<PriceType>::value, "Price ladder requires integral tick prices");
+
+public:
+    using LevelType = PriceLevel<OrderType>;
+
+    static constexpr bool is_bid = std::is_same<Compare, std::greater<PriceType>>::value;
+    static constexpr size_t initial_levels = 4096;
+    static constexpr size_t max_levels = size_t{1} << 24;
+
+private:
+    static constexpr size_t npos = SIZE_MAX;
+
+    using LevelVector = std::vector<LevelType, typename AllocPolicy::template Allocator<LevelType>>;
+    using BitmapVector = std::vector<uint64_t, typename AllocPolicy::template Allocator<uint64_t>>;
+
+    LevelVector levels;
+    BitmapVector bitmap;
+    PriceType base = 0;
+    size_t best = npos;
+    size_t order_count = 0;
+    size_t level_count = 0;
+
+public:
+    explicit LadderSide(typename AllocPolicy::Arena& arena)
+        : levels(AllocPolicy::template allocator<LevelType>(arena)),
+          bitmap(AllocPolicy::template allocator<uint64_t>(arena)) {}
+
+    void add(OrderType* order) {
+        size_t idx = indexFor(order->price);
+        LevelType& level = levels[idx];
+        if (level.empty()) {
+            setBit(idx);
+            ++level_count;
+            if (best == npos || better(idx, best)) best = idx;
+        }
+        level.pushBack(order);
+        ++order_count;
+    }
+
+    // Bulk load in priority order; a ladder insert is already O(1)
+    void addBack(OrderType* order) { add(order); }
+
+    bool empty() const { return order_count == 0; }
+
+    // Best price on this side (caller checks empty() first)
+    PriceType bestPrice() const { return base + static_cast<PriceType>(best); }
+
+    // Oldest order at the best price, left in place (nullptr if empty)
+    OrderType* front() const {
+        return best == npos ? nullptr : levels[best].head;
+    }
+
+    // Remove and return the oldest order at the best price
+    OrderType* popFront() {
+        if (best == npos) return nullptr;
+
+        OrderType* order = levels[best].popFront();
+        --order_count;
+        if (levels[best].empty()) retireBest();
+        return order;
+    }
+
+    // Fill quantity against the front order in place (see BookSide::fillFront)
+    OrderType* fillFront(int quantity) {
+        LevelType& level = levels[best];
+        level.head->quantity -= quantity;
+        level.total_quantity -= quantity;
+        if (level.head->quantity > 0) return nullptr;
+
+        OrderType* order = level.popFront();
+        --order_count;
+        if (level.empty()) retireBest();
+        return order;
+    }
+
+    // Unlink a resting order from its level in O(1)
+    void remove(OrderType* order) {
+        size_t idx = static_cast<size_t>(order->price - base);
+        LevelType& level = levels[idx];
+        level.unlink(order);
+        --order_count;
+        if (!level.empty()) return;
+
+        if (idx == best) {
+            retireBest();
+        } else {
+            clearBit(idx);
+            --level_count;
+        }
+    }
+
+    // Reduce a resting order's quantity in place, keeping time priority
+    void reduce(OrderType* order, int quantity) {
+        levels[static_cast<size_t>(order->price - base)].reduce(order, quantity);
+    }
+
+    const LevelType* findLevel(PriceType price) const {
+        if (levels.empty() || price < base) return nullptr;
+        size_t idx = static_cast<size_t>(price - base);
+        if (idx >= levels.size() || levels[idx].empty()) return nullptr;
+        return &levels[idx];
+    }
+
+    // Level at the best price (nullptr if empty)
+    const LevelType* bestLevel() const {
+        return best == npos ? nullptr : &levels[best];
+    }
+
+    // Next occupied level after an occupied price, in priority order
+    const LevelType* levelAfter(PriceType price, PriceType& next_price) const {
+        size_t idx = nextLevel(static_cast<size_t>(price - base));
+        if (idx == npos) return nullptr;
+        next_price = base + static_cast<PriceType>(idx);
+        return &levels[idx];
+    }
+
+    // Visit up to max_count levels in priority order as (price, level)
+    template <typename Visitor>
+    void forEachLevel(size_t max_count, Visitor&& visit) const {
+        size_t visited = 0;
+        for (size_t idx = best; idx != npos && visited++ < max_count; idx = nextLevel(idx)) {
+            visit(base + static_cast<PriceType>(idx), levels[idx]);
+        }
+    }
+
+    // Visit up to max_orders orders in priority order (price, then time)
+    template <typename Visitor>
+    void forEachOrder(size_t max_orders, Visitor&& visit) const {
+        size_t visited = 0;
+        for (size_t idx = best; idx != npos; idx = nextLevel(idx)) {
+            for (const OrderType* order = levels[idx].head; order; order = order->next) {
+                if (visited++ == max_orders) return;
+                visit(order);
+            }
+        }
+    }
+
+    size_t orderCount() const { return order_count; }
+    size_t levelCount() const { return level_count; }
+
+private:
+    bool better(size_t a, size_t b) const { return is_bid ? a > b : a < b; }
+
+    void setBit(size_t idx) { bitmap[idx >> 6] |= uint64_t{1} << (idx & 63); }
+    void clearBit(size_t idx) { bitmap[idx >> 6] &= ~(uint64_t{1} << (idx & 63)); }
+
+    // Best level just emptied: move to the next occupied level in priority order
+    void retireBest() {
+        clearBit(best);
+        --level_count;
+        best = (level_count == 0) ? npos : nextLevel(best);
+    }
+
+    size_t nextLevel(size_t idx) const {
+        return is_bid ? scanDown(idx) : scanUp(idx);
+    }
+
+    // Highest occupied level strictly below idx
+    size_t scanDown(size_t idx) const {
+        if (idx == 0) return npos;
+        --idx;
+        size_t word = idx >> 6;
+        uint64_t bits = bitmap[word] & (~uint64_t{0} >> (63 - (idx & 63)));
+        while (true) {
+            if (bits) return (word << 6) + ladder_detail::highestBit(bits);
+            if (word == 0) return npos;
+            bits = bitmap[--word];
+        }
+    }
+
+    // Lowest occupied level strictly above idx
+    size_t scanUp(size_t idx) const {
+        ++idx;
+        if (idx >= levels.size()) return npos;
+        size_t word = idx >> 6;
+        uint64_t bits = bitmap[word] & (~uint64_t{0} << (idx & 63));
+        while (true) {
+            if (bits) return (word << 6) + ladder_detail::lowestBit(bits);
+            if (++word == bitmap.size()) return npos;
+            bits = bitmap[word];
+        }
+    }
+
+    size_t indexFor(PriceType price) {
+        if (levels.empty()) {
+            levels.resize(initial_levels);
+            bitmap.resize(initial_levels / 64);
+            base = price - static_cast<PriceType>(initial_levels / 2);
+        }
+        if (price < base || price - base >= static_cast<PriceType>(levels.size())) {
+            regrow(price);
+        }
+        return static_cast<size_t>(price - base);
+    }
+
+    // Slow path: re-centre the ladder on the occupied range plus the new
+    // price, doubling its size until that span fits with headroom
+    void regrow(PriceType price) {
+        PriceType low = price;
+        PriceType high = price;
+        for (size_t word = 0; word < bitmap.size(); ++word) {
+            if (bitmap[word]) {
+                low = std::min(low, base + static_cast<PriceType>((word << 6) + ladder_detail::lowestBit(bitmap[word])));
+                break;
+            }
+        }
+        for (size_t word = bitmap.size(); word > 0; --word) {
+            if (bitmap[word - 1]) {
+                high = std::max(high, base + static_cast<PriceType>(((word - 1) << 6) + ladder_detail::highestBit(bitmap[word - 1])));
+                break;
+            }
+        }
+
+        size_t span = static_cast<size_t>(high - low) + 1;
+        if (span > max_levels / 2) {
+            throw std::length_error("Price ladder range exceeds max_levels");
+        }
+
+        size_t new_size = levels.size();
+        while (new_size < span * 2) new_size *= 2;
+        PriceType new_base = low - static_cast<PriceType>((new_size - span) / 2);
+        PriceType shift = base - new_base;
+
+        LevelVector new_levels(new_size, LevelType{}, levels.get_allocator());
+        BitmapVector new_bitmap(new_size / 64, 0, bitmap.get_allocator());
+        for (size_t word = 0; word < bitmap.size(); ++word) {
+            for (uint64_t bits = bitmap[word]; bits; bits &= bits - 1) {
+                size_t idx = (word << 6) + ladder_detail::lowestBit(bits);
+                size_t moved = static_cast<size_t>(static_cast<PriceType>(idx) + shift);
+                new_levels[moved] = levels[idx];
+                new_bitmap[moved >> 6] |= uint64_t{1} << (moved & 63);
+            }
+        }
+
+        levels.swap(new_levels);
+        bitmap.swap(new_bitmap);
+        base = new_base;
+        if (best != npos) best = static_cast<size_t>(static_cast<PriceType>(best) + shift);
+    }
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+
+// Aggregated price level: an intrusive doubly-linked FIFO of resting orders
+// plus the cached total quantity at this price. OrderType must expose
+// `prev`, `next` and `quantity` members.
+template <typename OrderType>
+struct PriceLevel {
+    OrderType* head = nullptr;
+    OrderType* tail = nullptr;
+    long long total_quantity = 0;
+    size_t order_count = 0;
+
+    bool empty() const { return head == nullptr; }
+
+    // Append an order at the back of the queue (lowest time priority)
+    void pushBack(OrderType* order) {
+        order->prev = tail;
+        order->next = nullptr;
+        if (tail) {
+            tail->next = order;
+        } else {
+            head = order;
+        }
+        tail = order;
+        total_quantity += order->quantity;
+        ++order_count;
+    }
+
+    // Remove and return the order at the front of the queue
+    OrderType* popFront() {
+        OrderType* order = head;
+        if (!order) return nullptr;
+
+        head = order->next;
+        if (head) {
+            head->prev = nullptr;
+        } else {
+            tail = nullptr;
+        }
+        order->next = nullptr;
+        total_quantity -= order->quantity;
+        --order_count;
+        return order;
+    }
+
+    // Unlink an order from anywhere in the queue in O(1)
+    void unlink(OrderType* order) {
+        if (order->prev) {
+            order->prev->next = order->next;
+        } else {
+            head = order->next;
+        }
+        if (order->next) {
+            order->next->prev = order->prev;
+        } else {
+            tail = order->prev;
+        }
+        order->prev = nullptr;
+        order->next = nullptr;
+        total_quantity -= order->quantity;
+        --order_count;
+    }
+
+    // Reduce an order's quantity in place (keeps its queue position)
+    void reduce(OrderType* order, int quantity) {
+        order->quantity -= quantity;
+        total_quantity -= quantity;
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "MappedFile.hpp"
+#include "MarketData.hpp"
+
+// What a session event asks the replayer to do
+enum class SessionEventType : uint8_t {
+    Tick = 1,          // market data update (bid/ask/sizes)
+    Order = 2,         // new order sent through the matching engine
+    RestingOrder = 3   // order placed straight into the book (book building)
+};
+
+// One recorded event. Ticks use the bid/ask fields, orders the
+// price/quantity/side fields; the rest stay zero.
+#pragma pack(push, 1)
+struct SessionEvent {
+    int64_t timestamp_ns;  // since the recorder was opened
+    double bid_price;
+    double ask_price;
+    double price;
+    uint32_t symbol;       // SymbolId, resolved through the file's symbol table
+    int32_t bid_size;
+    int32_t ask_size;
+    int32_t quantity;
+    uint8_t type;          // SessionEventType
+    uint8_t is_buy;
+    uint8_t reserved[6];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(SessionEvent) == 56, "SessionEvent must stay packed");
+
+namespace session_format {
+constexpr char magic[8] = {'H', 'F', 'T', 'S', 'E', 'S', 'N', '1'};
+constexpr uint32_t version = 1;
+}
+
+// Captures a session (ticks plus order intents) into a memory-mapped file
+// so it can be replayed on identical input. Each record call is a clock
+// read and a memcpy into the mapping.
+class SessionRecorder {
+public:
+    explicit SessionRecorder(const std::string& path);
+
+    bool isOpen() const { return file.isOpen(); }
+
+    void recordTick(const MarketData& tick);
+    void recordOrder(SymbolId symbol, double price, int quantity, bool is_buy,
+                     SessionEventType type = SessionEventType::Order);
+
+    // Write the symbol table and close the file
+    void close() { file.close(); }
+
+    uint64_t eventCount() const { return file.recordCount(); }
+    const std::string& path() const { return file.path(); }
+
+private:
+    MappedRecordWriter file;
+    uint64_t start_ns;
+};
+
+// Read-only, memory-mapped view of a recorded session
+class SessionReader {
+public:
+    explicit SessionReader(const std::string& path)
+        : file(path, session_format::magic, sizeof(SessionEvent)) {}
+
+    bool isOpen() const { return file.isOpen(); }
+
+    size_t size() const { return static_cast<size_t>(file.recordCount()); }
+    const SessionEvent& operator[](size_t i) const { return file.records<SessionEvent>()[i]; }
+    const SessionEvent* begin() const { return file.records<SessionEvent>(); }
+    const SessionEvent* end() const { return begin() + size(); }
+
+    // Symbol name recorded for an id ("" if unknown)
+    const std::string& symbol(uint32_t id) const { return file.symbol(id); }
+
+    // Recorded ids mapped to this process's interned ids
+    std::vector<SymbolId> internSymbols() const { return file.internSymbols(); }
+
+private:
+    MappedRecordReader file;
+};
@@ -0,0 +1,292 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "MappedFile.hpp"
+#include "OrderBook.hpp"
+#include "OrderManager.hpp"
+
+// What a snapshot record holds
+enum class SnapshotRecordType : uint8_t {
+    OrderInfo = 1,     // OrderManager record (every order ever created)
+    RestingOrder = 2   // order resting in a book, in book priority order
+};
+
+// One snapshot record. Prices are stored both ways so a snapshot is only
+// restored into a book with the same kind of price (price_ticks is used
+// for integral PriceType, price for floating point).
+#pragma pack(push, 1)
+struct SnapshotRecord {
+    int64_t id;
+    int64_t price_ticks;
+    double price;
+    int64_t created_ns;         // OrderInfo creation time, since the clock's epoch
+    int64_t updated_ns;         // OrderInfo only
+    uint32_t symbol;            // SymbolId, resolved through the file's symbol table
+    int32_t quantity;           // remaining quantity
+    int32_t original_quantity;  // OrderInfo only
+    uint8_t type;               // SnapshotRecordType
+    uint8_t is_buy;
+    uint8_t state;              // OrderState (OrderInfo only)
+    uint8_t integral_price;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(SnapshotRecord) == 56, "SnapshotRecord must stay packed");
+
+// Snapshot files are a MappedFileHeader ("HFTSNAP1") followed by all
+// OrderInfo records in id order, then each book's resting orders (bids,
+// then asks, best level first) and the symbol table
+namespace snapshot_format {
+constexpr char magic[8] = {'H', 'F', 'T', 'S', 'N', 'A', 'P', '1'};
+constexpr uint32_t version = 1;
+}
+
+namespace snapshot_detail {
+
+using Clock = std::chrono::high_resolution_clock;
+
+inline int64_t toNs(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+inline Clock::time_point fromNs(int64_t ns) {
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+template <typename PriceType>
+void encodePrice(PriceType price, SnapshotRecord& record) {
+    record.integral_price = std::is_integral<PriceType>::value ? 1 : 0;
+    record.price = static_cast<double>(price);
+    record.price_ticks = std::is_integral<PriceType>::value ? static_cast<int64_t>(price) : 0;
+}
+
+template <typename PriceType>
+bool decodePrice(const SnapshotRecord& record, PriceType& price) {
+    if (record.integral_price != (std::is_integral<PriceType>::value ? 1 : 0)) return false;
+    price = std::is_integral<PriceType>::value ? static_cast<PriceType>(record.price_ticks)
+                                               : static_cast<PriceType>(record.price);
+    return true;
+}
+
+// Resting orders carry only the book node's fields; times live in the
+// order's OrderInfo record
+template <typename PriceType, typename OrderIdType>
+void encodeOrder(const Order<PriceType, OrderIdType>& order, SymbolId symbol, SnapshotRecord& record) {
+    record = SnapshotRecord{};
+    record.id = static_cast<int64_t>(order.id);
+    encodePrice(order.price, record);
+    record.symbol = symbol;
+    record.quantity = order.quantity;
+    record.type = static_cast<uint8_t>(SnapshotRecordType::RestingOrder);
+    record.is_buy = order.is_buy ? 1 : 0;
+}
+
+// Copy one side of a book in priority order. Each level is a linked list
+// of nodes scattered across the pool, so following one list at a time
+// stalls on every node. Instead up to `lanes` levels are walked together,
+// each writing into its own slice of the output (known from the level
+// order counts), which keeps that many cache misses in flight.
+template <typename PriceType, typename OrderIdType, typename... Policies>
+void captureSide(const OrderBook<PriceType, OrderIdType, Policies...>& book, bool is_buy,
+                 std::vector<SnapshotRecord>& records) {
+    using OrderType = Order<PriceType, OrderIdType>;
+    static constexpr size_t lanes = 16;
+
+    struct Cursor {
+        const OrderType* order;
+        size_t out;
+    };
+
+    const SymbolId symbol = book.getSymbolId();
+    std::vector<Cursor> levels;
+    size_t out = records.size();
+    book.forEachLevel(is_buy, [&](PriceType, const PriceLevel<OrderType>& level) {
+        levels.push_back(Cursor{level.head, out});
+        out += level.order_count;
+    });
+    records.resize(out);
+
+    Cursor active[lanes];
+    size_t active_count = 0;
+    size_t next_level = 0;
+    while (active_count < lanes && next_level < levels.size()) active[active_count++] = levels[next_level++];
+
+    while (active_count > 0) {
+        for (size_t lane = 0; lane < active_count;) {
+            Cursor& cursor = active[lane];
+            encodeOrder(*cursor.order, symbol, records[cursor.out++]);
+            cursor.order = cursor.order->next;
+            if (cursor.order) {
+                ++lane;
+            } else if (next_level < levels.size()) {
+                cursor = levels[next_level++];
+                ++lane;
+            } else {
+                cursor = active[--active_count];
+            }
+        }
+    }
+}
+
+}  // namespace snapshot_detail
+
+// Writes captured records to a snapshot file. writeAsync() hands the
+// records to a background thread, so the matching thread only pays for the
+// capture copy; the file is complete once wait() returns true.
+class SnapshotWriter {
+public:
+    SnapshotWriter() = default;
+    ~SnapshotWriter() { wait(); }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    // Synchronous write of a whole snapshot
+    static bool writeFile(const std::string& path, const std::vector<SnapshotRecord>& records);
+
+    // Start writing in the background (waits for a previous write first)
+    void writeAsync(const std::string& path, std::vector<SnapshotRecord> records);
+
+    // Join the background write; true if the last file was written
+    bool wait();
+
+    // Storage for the next capture: the last snapshot's records, emptied
+    // once written but keeping their capacity, so periodic captures don't
+    // allocate or page-fault a fresh buffer
+    std::vector<SnapshotRecord> takeBuffer();
+
+    bool started() const { return !file_path.empty(); }
+    const std::string& path() const { return file_path; }
+    uint64_t recordCount() const { return record_count; }
+    uint64_t writeNs() const { return write_ns; }
+
+private:
+    std::thread worker;
+    std::vector<SnapshotRecord> pending;
+    std::string file_path;
+    uint64_t record_count = 0;
+    uint64_t write_ns = 0;
+    bool succeeded = false;
+};
+
+// Read-only, memory-mapped view of a snapshot file
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& path)
+        : file(path, snapshot_format::magic, sizeof(SnapshotRecord)) {}
+
+    bool isOpen() const { return file.isOpen(); }
+
+    size_t size() const { return static_cast<size_t>(file.recordCount()); }
+    const SnapshotRecord& operator[](size_t i) const { return file.records<SnapshotRecord>()[i]; }
+    const SnapshotRecord* begin() const { return file.records<SnapshotRecord>(); }
+    const SnapshotRecord* end() const { return begin() + size(); }
+
+    // Recorded ids mapped to this process's interned ids
+    std::vector<SymbolId> internSymbols() const { return file.internSymbols(); }
+
+private:
+    MappedRecordReader file;
+};
+
+// Capture: call at a quiescent point (between matchOrder calls), then hand
+// the records to a SnapshotWriter. The copy is the only pause matching sees:
+//
+//     std::vector<SnapshotRecord> records = writer.takeBuffer();
+//     captureOrderManager(manager, records);
+//     captureBook(book, records);
+//     writer.writeAsync(path, std::move(records));
+
+// Append every OrderManager record, in id order
+template <typename PriceType, typename OrderIdType>
+void captureOrderManager(const OrderManager<PriceType, OrderIdType>& manager,
+                         std::vector<SnapshotRecord>& records) {
+    manager.forEachOrder([&records](const OrderInfo<PriceType, OrderIdType>& info) {
+        SnapshotRecord record{};
+        record.id = static_cast<int64_t>(info.id);
+        snapshot_detail::encodePrice(info.price, record);
+        record.created_ns = snapshot_detail::toNs(info.created_at);
+        record.updated_ns = snapshot_detail::toNs(info.updated_at);
+        record.symbol = info.symbol;
+        record.quantity = info.remaining_quantity;
+        record.original_quantity = info.original_quantity;
+        record.type = static_cast<uint8_t>(SnapshotRecordType::OrderInfo);
+        record.is_buy = info.is_buy ? 1 : 0;
+        record.state = static_cast<uint8_t>(info.state);
+        records.push_back(record);
+    });
+}
+
+// Append a book's resting orders in priority order (bids, then asks)
+template <typename PriceType, typename OrderIdType, typename... Policies>
+void captureBook(const OrderBook<PriceType, OrderIdType, Policies...>& book, std::vector<SnapshotRecord>& records) {
+    snapshot_detail::captureSide(book, true, records);
+    snapshot_detail::captureSide(book, false, records);
+}
+
+// Restore: load into an empty manager first, then each book. Both return
+// false (after loading nothing, or only a prefix for the manager) if the
+// target isn't empty, the snapshot doesn't match its price type, or a
+// record is out of range (unknown order state, resting quantity outside
+// 1..Order::max_quantity).
+
+template <typename PriceType, typename OrderIdType>
+bool restoreOrderManager(const SnapshotReader& snapshot, OrderManager<PriceType, OrderIdType>& manager) {
+    if (manager.getTotalOrders() != 0) return false;
+
+    const std::vector<SymbolId> symbols = snapshot.internSymbols();
+    size_t count = 0;
+    for (const SnapshotRecord& record : snapshot) {
+        if (record.type == static_cast<uint8_t>(SnapshotRecordType::OrderInfo)) ++count;
+    }
+    manager.reserve(count);
+
+    OrderInfo<PriceType, OrderIdType> info;
+    for (const SnapshotRecord& record : snapshot) {
+        if (record.type != static_cast<uint8_t>(SnapshotRecordType::OrderInfo)) continue;
+        if (!snapshot_detail::decodePrice(record, info.price)) return false;
+        if (record.state >= order_state_count) return false;  // corrupt or foreign snapshot
+        info.id = static_cast<OrderIdType>(record.id);
+        info.symbol = record.symbol < symbols.size() ? symbols[record.symbol] : SymbolId{0};
+        info.original_quantity = record.original_quantity;
+        info.remaining_quantity = record.quantity;
+        info.is_buy = record.is_buy != 0;
+        info.state = static_cast<OrderState>(record.state);
+        info.created_at = snapshot_detail::fromNs(record.created_ns);
+        info.updated_at = snapshot_detail::fromNs(record.updated_ns);
+        if (!manager.restoreOrderInfo(info)) return false;
+    }
+    return true;
+}
+
+// Rebuild the book's resting orders (those recorded under its symbol).
+// Records are already in priority order, so the book is bulk-built with
+// OrderBook::restoreOrders rather than re-inserted one search at a time.
+template <typename PriceType, typename OrderIdType, typename... Policies>
+bool restoreBook(const SnapshotReader& snapshot, OrderManager<PriceType, OrderIdType>& manager,
+                 OrderBook<PriceType, OrderIdType, Policies...>& book) {
+    if (book.getTotalOrderCount() != 0) return false;
+
+    const std::vector<SymbolId> symbols = snapshot.internSymbols();
+    const SymbolId book_symbol = book.getSymbolId();
+
+    std::vector<UniqueOrderPtr<PriceType, OrderIdType>> orders;
+    for (const SnapshotRecord& record : snapshot) {
+        if (record.type != static_cast<uint8_t>(SnapshotRecordType::RestingOrder)) continue;
+        if (record.symbol >= symbols.size() || symbols[record.symbol] != book_symbol) continue;
+
+        PriceType price;
+        if (!snapshot_detail::decodePrice(record, price)) return false;
+        if (record.quantity <= 0 || record.quantity > Order<PriceType, OrderIdType>::max_quantity) return false;
+        orders.push_back(manager.rebuildOrder(static_cast<OrderIdType>(record.id), price,
+                                              record.quantity, record.is_buy != 0));
+    }
+
+    book.restoreOrders(orders.data(), orders.size());
+    return true;
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include "PriceLevel.hpp"
+#include "MemoryPool.hpp"
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// One side of the book as a contiguous array of price levels sorted from
+// worst to best, so the best level sits at the back. Activity concentrates
+// near the touch: adding at or near the best price, filling and retiring
+// the best level only touch the end of the array. Prices within the last
+// few levels are found by a short linear scan, deeper ones by binary
+// search; inserting or erasing a deep level shifts the levels behind it.
+// Works for any ordered PriceType. AllocPolicy supplies the array allocator.
+template <typename PriceType, typename OrderType, typename Compare, typename AllocPolicy = HeapAllocation>
+class SortedVectorSide {
+public:
+    using LevelType = PriceLevel<OrderType>;
+
+    // Levels nearest the touch checked one by one before binary searching
+    static constexpr size_t linear_scan = 8;
+
+private:
+    static constexpr size_t npos = SIZE_MAX;
+
+    struct Entry {
+        PriceType price;
+        LevelType level;
+    };
+
+    std::vector<Entry, typename AllocPolicy::template Allocator<Entry>> levels;
+    size_t order_count = 0;
+
+public:
+    explicit SortedVectorSide(typename AllocPolicy::Arena& arena)
+        : levels(AllocPolicy::template allocator<Entry>(arena)) {}
+
+    void add(OrderType* order) {
+        size_t idx = lowerBound(order->price);
+        if (idx == levels.size() || levels[idx].price != order->price) {
+            levels.insert(levels.begin() + idx, Entry{order->price, LevelType{}});
+        }
+        levels[idx].level.pushBack(order);
+        ++order_count;
+    }
+
+    // Bulk load in priority order: each new level is the worst so far and
+    // goes to the front, so this stays O(levels) per level either way
+    void addBack(OrderType* order) { add(order); }
+
+    bool empty() const { return order_count == 0; }
+
+    // Best price on this side (caller checks empty() first)
+    PriceType bestPrice() const { return levels.back().price; }
+
+    // Oldest order at the best price, left in place (nullptr if empty)
+    OrderType* front() const {
+        return levels.empty() ? nullptr : levels.back().level.head;
+    }
+
+    // Remove and return the oldest order at the best price
+    OrderType* popFront() {
+        if (levels.empty()) return nullptr;
+
+        LevelType& level = levels.back().level;
+        OrderType* order = level.popFront();
+        if (level.empty()) {
+            levels.pop_back();
+        }
+        --order_count;
+        return order;
+    }
+
+    // Fill quantity against the front order in place (see BookSide::fillFront)
+    OrderType* fillFront(int quantity) {
+        LevelType& level = levels.back().level;
+        level.head->quantity -= quantity;
+        level.total_quantity -= quantity;
+        if (level.head->quantity > 0) return nullptr;
+
+        OrderType* order = level.popFront();
+        if (level.empty()) {
+            levels.pop_back();
+        }
+        --order_count;
+        return order;
+    }
+
+    // Unlink a resting order from its level
+    void remove(OrderType* order) {
+        size_t idx = find(order->price);
+        LevelType& level = levels[idx].level;
+        level.unlink(order);
+        if (level.empty()) {
+            levels.erase(levels.begin() + idx);
+        }
+        --order_count;
+    }
+
+    // Reduce a resting order's quantity in place, keeping time priority
+    void reduce(OrderType* order, int quantity) {
+        levels[find(order->price)].level.reduce(order, quantity);
+    }
+
+    const LevelType* findLevel(PriceType price) const {
+        size_t idx = find(price);
+        return idx == npos ? nullptr : &levels[idx].level;
+    }
+
+    // Level at the best price (nullptr if empty)
+    const LevelType* bestLevel() const {
+        return levels.empty() ? nullptr : &levels.back().level;
+    }
+
+    // Next level after price in priority order (nullptr if none)
+    const LevelType* levelAfter(PriceType price, PriceType& next_price) const {
+        size_t idx = lowerBound(price);
+        if (idx == 0) return nullptr;
+        next_price = levels[idx - 1].price;
+        return &levels[idx - 1].level;
+    }
+
+    // Visit up to max_count levels in priority order as (price, level)
+    template <typename Visitor>
+    void forEachLevel(size_t max_count, Visitor&& visit) const {
+        size_t visited = 0;
+        for (size_t idx = levels.size(); idx > 0 && visited++ < max_count; --idx) {
+            visit(levels[idx - 1].price, levels[idx - 1].level);
+        }
+    }
+
+    // Visit up to max_orders orders in priority order (price, then time)
+    template <typename Visitor>
+    void forEachOrder(size_t max_orders, Visitor&& visit) const {
+        size_t visited = 0;
+        for (size_t idx = levels.size(); idx > 0; --idx) {
+            for (const OrderType* order = levels[idx - 1].level.head; order; order = order->next) {
+                if (visited++ == max_orders) return;
+                visit(order);
+            }
+        }
+    }
+
+    size_t orderCount() const { return order_count; }
+    size_t levelCount() const { return levels.size(); }
+
+private:
+    static bool better(PriceType a, PriceType b) { return Compare()(a, b); }
+
+    // First index whose price is not worse than `price` (levels.size() if
+    // price beats every level): the insert position, or the level itself
+    size_t lowerBound(PriceType price) const {
+        size_t idx = levels.size();
+        for (size_t steps = 0; idx > 0 && steps < linear_scan; ++steps, --idx) {
+            if (better(price, levels[idx - 1].price)) return idx;
+        }
+        if (idx == 0) return 0;
+
+        auto it = std::partition_point(levels.begin(), levels.begin() + idx,
+                                       [price](const Entry& entry) { return better(price, entry.price); });
+        return static_cast<size_t>(it - levels.begin());
+    }
+
+    size_t find(PriceType price) const {
+        size_t idx = lowerBound(price);
+        return (idx < levels.size() && levels[idx].price == price) ? idx : npos;
+    }
+};
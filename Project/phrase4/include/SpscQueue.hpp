@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free single-producer/single-consumer ring buffer.
+// Capacity is rounded up to a power of two. Head and tail live on separate
+// cache lines, and each side keeps a cached copy of the other's index so
+// the shared counters are only re-read when the ring looks full/empty.
+template <typename T>
+class SpscQueue {
+private:
+    static constexpr size_t cache_line = 64;
+
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+
+    alignas(cache_line) std::atomic<size_t> head{0};  // next slot to read (consumer)
+    size_t cached_tail = 0;                            // consumer's view of tail
+
+    alignas(cache_line) std::atomic<size_t> tail{0};  // next slot to write (producer)
+    size_t cached_head = 0;                            // producer's view of head
+
+public:
+    explicit SpscQueue(size_t capacity = 1024) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots = std::make_unique<T[]>(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side: returns false when the ring is full
+    bool tryPush(const T& item) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head > mask) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t - cached_head > mask) return false;
+        }
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: returns false when the ring is empty
+    bool tryPop(T& item) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h == cached_tail) return false;
+        }
+        item = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently with push/pop
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return mask + 1; }
+};
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Timer.hpp"
+#include "LatencyHistogram.hpp"
+
+// Per-stage latency probes. A probe brackets one stage of a loop (tick
+// generation, order creation, matching, logging, ...) with two raw cycle
+// counter reads (rdtsc without the Timer's fences, steady_clock when the
+// TSC is unusable) and stores the pair in a fixed per-thread ring, so the
+// hot path is two timestamp reads and a store. Converting samples into one
+// histogram per stage happens only in collect() / printReport(), or in
+// HFT_PROBE_DRAIN() between measured windows; a ring that wraps before
+// either keeps its most recent samples and counts the rest as overwritten.
+//
+//     HFT_PROBE_SCOPE("match");                 // until the end of the scope
+//     HFT_PROBE_BEGIN(create, "create");        // explicit begin/end, for
+//     auto order = manager.createOrder(...);    // stages whose results
+//     HFT_PROBE_END(create);                    // outlive the stage
+//     ...
+//     latencies.record(timer.stop());
+//     HFT_PROBE_DRAIN();                        // outside the timed window
+//
+// Built with -DHFT_STAGE_PROBES (CMake option HFT_STAGE_PROBES, on by
+// default). Without it the macros expand to nothing and collect() reports
+// no stages.
+
+namespace stage_probe {
+
+using StageId = uint32_t;
+
+// Register a stage name (same name -> same id); thread-safe
+StageId registerStage(const char* name);
+
+// One stage's merged latencies across all threads
+struct StageStats {
+    std::string name;
+    LatencyHistogram latency;
+};
+
+// Fold every thread's pending samples and return stages with samples, in
+// registration order. Call while the probed threads are quiescent.
+std::vector<StageStats> collect();
+
+// Drop all samples (e.g. between runs); same quiescence rule as collect()
+void reset();
+
+// Samples lost because a thread's ring wrapped before it was folded
+size_t overwrittenSamples();
+
+// Per-stage percentile table plus each stage's share of the probed time
+void printReport(std::ostream& out, const std::string& title);
+
+bool enabled();
+
+using Backend = std::decay<decltype(Timer().getBackend())>::type;
+
+// Raw samples of one thread, drained into per-stage histograms
+class ThreadRing {
+public:
+    static constexpr size_t capacity = size_t(1) << 14;  // power of two
+
+    ThreadRing();
+    ~ThreadRing();
+
+    ThreadRing(const ThreadRing&) = delete;
+    ThreadRing& operator=(const ThreadRing&) = delete;
+
+    uint64_t stamp() const {
+#if HFT_TSC_AVAILABLE
+        if (raw_tsc) return __rdtsc();
+#endif
+        return backend.begin();
+    }
+
+    // Never folds: a full ring overwrites its oldest pending sample
+    void record(StageId stage, uint64_t start, uint64_t stop) {
+        samples[recorded & (capacity - 1)] = Sample{start, stop, stage};
+        ++recorded;
+    }
+
+    size_t pending() const { return static_cast<size_t>(recorded - folded); }
+
+    // Convert pending samples into the per-stage histograms
+    void fold();
+
+    void clear();
+
+    const std::vector<LatencyHistogram>& histograms() const { return stage_histograms; }
+    size_t overwritten() const { return overwritten_samples; }
+
+private:
+    struct Sample {
+        uint64_t start;
+        uint64_t stop;
+        StageId stage;
+    };
+
+    Backend backend;
+    bool raw_tsc;  // stamps are TSC ticks, in the backend's units
+    std::unique_ptr<Sample[]> samples;
+    uint64_t recorded = 0;  // samples ever recorded; slot = recorded & (capacity - 1)
+    uint64_t folded = 0;
+    size_t overwritten_samples = 0;
+    std::vector<LatencyHistogram> stage_histograms;  // indexed by StageId
+};
+
+inline ThreadRing& threadRing() {
+    thread_local ThreadRing ring;
+    return ring;
+}
+
+// Fold the calling thread's ring once it is half full; one compare
+// otherwise. Call between measured windows, never inside one.
+inline void drain() {
+    ThreadRing& ring = threadRing();
+    if (ring.pending() >= ThreadRing::capacity / 2) ring.fold();
+}
+
+// Times from construction to end() (or destruction)
+class ScopedProbe {
+public:
+    explicit ScopedProbe(StageId id) : ring(threadRing()), stage(id), start(ring.stamp()) {}
+    ~ScopedProbe() { end(); }
+
+    ScopedProbe(const ScopedProbe&) = delete;
+    ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+    void end() {
+        if (done) return;
+        ring.record(stage, start, ring.stamp());
+        done = true;
+    }
+
+private:
+    ThreadRing& ring;
+    StageId stage;
+    uint64_t start;
+    bool done = false;
+};
+
+}  // namespace stage_probe
+
+#define HFT_PROBE_CONCAT_INNER(a, b) a##b
+#define HFT_PROBE_CONCAT(a, b) HFT_PROBE_CONCAT_INNER(a, b)
+
+#if defined(HFT_STAGE_PROBES)
+// The stage id is looked up once per call site
+#define HFT_PROBE_BEGIN(probe, name)                                                              \
+    static const ::stage_probe::StageId HFT_PROBE_CONCAT(probe, _stage_id) =                     \
+        ::stage_probe::registerStage(name);                                                       \
+    ::stage_probe::ScopedProbe probe(HFT_PROBE_CONCAT(probe, _stage_id))
+#define HFT_PROBE_END(probe) probe.end()
+#define HFT_PROBE_SCOPE(name) HFT_PROBE_BEGIN(HFT_PROBE_CONCAT(hft_probe_, __LINE__), name)
+#define HFT_PROBE_DRAIN() ::stage_probe::drain()
+#else
+#define HFT_PROBE_BEGIN(probe, name) static_cast<void>(0)
+#define HFT_PROBE_END(probe) static_cast<void>(0)
+#define HFT_PROBE_SCOPE(name) static_cast<void>(0)
+#define HFT_PROBE_DRAIN() static_cast<void>(0)
+#endif
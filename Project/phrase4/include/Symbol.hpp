@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+
+// Compact interned symbol identifier carried by hot-path structs
+using SymbolId = uint32_t;
+
+// Process-wide symbol registry. Strings are interned once (outside the hot
+// path) and only resolved back to names at logging/reporting time.
+// Id 0 is reserved for the empty symbol.
+class SymbolRegistry {
+public:
+    static SymbolRegistry& instance();
+
+    // Return the id for a symbol, registering it on first use
+    SymbolId intern(const std::string& symbol);
+
+    // Resolve an id back to its name (empty string for unknown ids)
+    const std::string& name(SymbolId id) const;
+
+    size_t size() const;
+
+private:
+    SymbolRegistry();
+
+    std::unordered_map<std::string, SymbolId> ids;
+    std::deque<std::string> names;  // deque keeps returned references stable
+    mutable std::mutex mutex;
+};
+
+inline SymbolId internSymbol(const std::string& symbol) {
+    return SymbolRegistry::instance().intern(symbol);
+}
+
+inline const std::string& symbolName(SymbolId id) {
+    return SymbolRegistry::instance().name(id);
+}
@@ -1,25 +1,129 @@
 #pragma once
 #include <chrono>
+#include <cstdint>
 
-class Timer {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define HFT_TSC_AVAILABLE 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define HFT_TSC_AVAILABLE 0
+#endif
+
+namespace timer_detail {
+
+inline uint64_t steadyNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Result of the one-time TSC check + calibration (src/Timer.cpp)
+struct TscCalibration {
+    bool usable;         // invariant TSC present and calibration sane
+    bool invariant;      // CPUID reports an invariant (constant, non-stop) TSC
+    double ns_per_tick;
+};
+
+// Measured on first call (~10 ms against steady_clock), then cached
+const TscCalibration& tscCalibration();
+
+#if HFT_TSC_AVAILABLE
+// lfence on both sides keeps earlier and later instructions from being
+// reordered around the read at the start of an interval
+inline uint64_t tscBegin() {
+    _mm_lfence();
+    uint64_t ticks = __rdtsc();
+    _mm_lfence();
+    return ticks;
+}
+
+// rdtscp waits for all earlier instructions to finish; the trailing lfence
+// keeps later ones from starting before the read
+inline uint64_t tscEnd() {
+    unsigned int aux;
+    uint64_t ticks = __rdtscp(&aux);
+    _mm_lfence();
+    return ticks;
+}
+#endif
+
+}  // namespace timer_detail
+
+// steady_clock timestamps in nanoseconds
+class SteadyClockBackend {
+public:
+    uint64_t begin() const { return timer_detail::steadyNs(); }
+    uint64_t end() const { return timer_detail::steadyNs(); }
+    long long toNanoseconds(uint64_t delta) const { return static_cast<long long>(delta); }
+    bool usingTsc() const { return false; }
+    static const char* name() { return "steady_clock"; }
+};
+
+// Cycle counter timestamps, converted with the startup calibration.
+// Falls back to steady_clock at runtime when the TSC is not invariant
+// (frequency changes / stops in deep C-states) or is not available.
+class TscBackend {
 public:
-    Timer() : m_start() {}
+    TscBackend()
+        : use_tsc(timer_detail::tscCalibration().usable),
+          ns_per_tick(timer_detail::tscCalibration().ns_per_tick) {}
+
+#if HFT_TSC_AVAILABLE
+    uint64_t begin() const { return use_tsc ? timer_detail::tscBegin() : timer_detail::steadyNs(); }
+    uint64_t end() const { return use_tsc ? timer_detail::tscEnd() : timer_detail::steadyNs(); }
+#else
+    uint64_t begin() const { return timer_detail::steadyNs(); }
+    uint64_t end() const { return timer_detail::steadyNs(); }
+#endif
+
+    long long toNanoseconds(uint64_t delta) const {
+        return use_tsc ? static_cast<long long>(delta * ns_per_tick) : static_cast<long long>(delta);
+    }
+
+    bool usingTsc() const { return use_tsc; }
+    static const char* name() { return "tsc"; }
+
+private:
+    bool use_tsc;
+    double ns_per_tick;
+};
+
+template <typename Backend>
+class BasicTimer {
+public:
+    BasicTimer() : m_start(0) {}
 
     void start() {
-        m_start = std::chrono::high_resolution_clock::now();
+        m_start = backend.begin();
     }
 
     long long stop() {
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count();
+        return interval(backend.end());
     }
 
     // Get elapsed time without stopping the timer
     long long elapsed() const {
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count();
+        return interval(backend.end());
     }
 
+    const Backend& getBackend() const { return backend; }
+
 private:
-    std::chrono::high_resolution_clock::time_point m_start;
+    long long interval(uint64_t end) const {
+        return end > m_start ? backend.toNanoseconds(end - m_start) : 0;
+    }
+
+    Backend backend;
+    uint64_t m_start;
 };
+
+// Backend chosen at compile time: -DHFT_TSC_TIMER (CMake option
+// HFT_TSC_TIMER, on by default) selects the TSC on x86
+#if defined(HFT_TSC_TIMER) && HFT_TSC_AVAILABLE
+using Timer = BasicTimer<TscBackend>;
+#else
+using Timer = BasicTimer<SteadyClockBackend>;
+#endif
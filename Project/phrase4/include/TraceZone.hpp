@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Timer.hpp"
+
+// Scoped trace zones for a timeline view of single slow operations.
+// HFT_TRACE_ZONE("MatchingEngine::matchOrder") records the zone's begin and
+// end cycle counts into the calling thread's event ring. trace::stop(), or
+// process exit after trace::start(), writes every thread's events as
+// Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+//
+//     trace::start("hft.trace.json");
+//     ...                                   // zones record while active
+//     trace::stop();                        // or let atexit write it
+//
+// Zones are compiled in with -DHFT_TRACE_ZONES (CMake option
+// HFT_TRACE_ZONES, on by default) and record only while a trace is
+// active; otherwise a zone costs one relaxed load. Stamps are raw rdtsc
+// reads without fences: they order zones on a timeline but are not meant
+// for timing a few instructions (use Timer for that).
+
+namespace trace {
+
+// Start recording; the trace is written to `path` by stop() or at exit.
+// Returns false if a trace is already active.
+bool start(const std::string& path);
+
+// Stop recording and write the JSON file. Call while the traced threads
+// are quiescent (joined or idle). Returns false if nothing was active or
+// the file could not be written.
+bool stop();
+
+bool active();
+
+// Whether zones are compiled in (HFT_TRACE_ZONES)
+bool enabled();
+
+// Events written by the last stop(), and those overwritten because a
+// thread's ring wrapped (the ring keeps each thread's most recent events)
+size_t writtenEvents();
+size_t overwrittenEvents();
+
+}  // namespace trace
+
+namespace trace_detail {
+
+#if HFT_TSC_AVAILABLE
+inline uint64_t stamp() { return __rdtsc(); }
+#else
+inline uint64_t stamp() { return timer_detail::steadyNs(); }
+#endif
+
+struct Event {
+    uint64_t begin;
+    uint64_t end;
+    const char* name;
+};
+
+// One thread's events, written only by that thread. Owned by the registry
+// and kept after the thread exits, so its events still reach the file.
+struct ThreadBuffer {
+    static constexpr size_t capacity = size_t(1) << 16;  // power of two
+
+    std::unique_ptr<Event[]> events{new Event[capacity]};
+    uint64_t head = 0;  // events ever recorded; slot = head & (capacity - 1)
+    uint32_t tid = 0;
+
+    void push(uint64_t begin, uint64_t end, const char* name) {
+        events[head & (capacity - 1)] = Event{begin, end, name};
+        ++head;
+    }
+};
+
+extern std::atomic<bool> g_active;
+
+// Registers the calling thread's buffer on its first zone (src/TraceZone.cpp)
+ThreadBuffer* registerThread();
+
+inline ThreadBuffer* threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) buffer = registerThread();
+    return buffer;
+}
+
+}  // namespace trace_detail
+
+namespace trace {
+
+class Zone {
+public:
+    explicit Zone(const char* zone_name) : name(zone_name) {
+        if (trace_detail::g_active.load(std::memory_order_relaxed)) {
+            buffer = trace_detail::threadBuffer();
+            begin = trace_detail::stamp();
+        }
+    }
+
+    ~Zone() {
+        if (buffer) buffer->push(begin, trace_detail::stamp(), name);
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* name;
+    trace_detail::ThreadBuffer* buffer = nullptr;
+    uint64_t begin = 0;
+};
+
+}  // namespace trace
+
+#if defined(HFT_TRACE_ZONES)
+#define HFT_TRACE_CONCAT_INNER(a, b) a##b
+#define HFT_TRACE_CONCAT(a, b) HFT_TRACE_CONCAT_INNER(a, b)
+#define HFT_TRACE_ZONE(name) ::trace::Zone HFT_TRACE_CONCAT(hft_trace_zone_, __LINE__)(name)
+#else
+#define HFT_TRACE_ZONE(name) static_cast<void>(0)
+#endif
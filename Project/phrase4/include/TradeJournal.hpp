@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "MappedFile.hpp"
+
+// Fixed-size packed trade record as stored in the binary journal
+#pragma pack(push, 1)
+struct TradeRecord {
+    int64_t timestamp_ns;
+    int64_t buy_order_id;
+    int64_t sell_order_id;
+    double price;
+    uint32_t symbol;     // SymbolId, resolved through the journal's symbol table
+    int32_t quantity;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TradeRecord) == 40, "TradeRecord must stay packed");
+
+// Journal files are a MappedFileHeader ("HFTJRNL1") followed by TradeRecords
+// and the symbol table
+using TradeJournalHeader = MappedFileHeader;
+
+namespace journal_format {
+constexpr char magic[8] = {'H', 'F', 'T', 'J', 'R', 'N', 'L', '1'};
+constexpr uint32_t version = 1;
+}
+
+// Append-only binary trade journal backed by a memory-mapped file
+class TradeJournal {
+public:
+    static constexpr size_t default_chunk_bytes = MappedRecordWriter::default_chunk_bytes;
+
+    explicit TradeJournal(const std::string& path, size_t chunk_bytes = default_chunk_bytes)
+        : file(path, journal_format::magic, journal_format::version, sizeof(TradeRecord), chunk_bytes) {}
+
+    bool isOpen() const { return file.isOpen(); }
+
+    // False if the record could not be written (see failedCount())
+    bool append(const TradeRecord& record) { return file.append(record); }
+
+    // Publish the record count in the header (no syscall)
+    void flush() { file.flush(); }
+
+    // Write the symbol table, truncate to the used size and unmap
+    void close() { file.close(); }
+
+    uint64_t recordCount() const { return file.recordCount(); }
+    uint64_t failedCount() const { return file.failedCount(); }
+    const std::string& path() const { return file.path(); }
+
+private:
+    MappedRecordWriter file;
+};
+
+// Read-only view of a journal file (used by the offline converter)
+class TradeJournalReader {
+public:
+    explicit TradeJournalReader(const std::string& path)
+        : file(path, journal_format::magic, sizeof(TradeRecord)) {}
+
+    bool isOpen() const { return file.isOpen(); }
+
+    uint64_t recordCount() const { return file.recordCount(); }
+    const TradeRecord& record(uint64_t i) const { return file.records<TradeRecord>()[i]; }
+
+    // Symbol name recorded for an id ("" if unknown)
+    const std::string& symbol(uint32_t id) const { return file.symbol(id); }
+
+private:
+    MappedRecordReader file;
+};
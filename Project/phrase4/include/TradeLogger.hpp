@@ -1,11 +1,27 @@
 #pragma once
 #include "MatchingEngine.hpp"
+#include "TradeJournal.hpp"
+#include "SpscQueue.hpp"
+#include "TraceZone.hpp"
 #include <vector>
 #include <fstream>
 #include <string>
 #include <memory>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+// On-disk format: CSV text, or the memory-mapped binary journal
+// (convert a journal back to CSV with tools/journal_to_csv)
+enum class LogFormat { Text, Binary };
+
+// What the hot path does when the async ring is full:
+// Block - spin until the writer frees a slot (no trade is lost)
+// Drop  - discard the trade and count it (bounded latency, lossy)
+// Spill - park it in an unbounded producer-side buffer, retried on later calls
+enum class OverflowPolicy { Block, Drop, Spill };
 
 // RAII-based Trade Logger
 template <typename PriceType, typename OrderIdType>
@@ -14,16 +30,47 @@ public:
     using TradeType = Trade<PriceType, OrderIdType>;
 
 private:
+    // Async mode: the logging thread only pushes into the SPSC ring and a
+    // dedicated writer thread drains, formats and writes. Heap-allocated so
+    // the writer's references survive moves of the logger.
+    struct AsyncState {
+        SpscQueue<TradeType> queue;
+        OverflowPolicy policy;
+        std::thread writer;
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> written{0};  // published by the writer after each flush
+
+        // Producer-owned
+        uint64_t enqueued = 0;
+        uint64_t dropped = 0;
+        std::vector<TradeType> spill;
+        size_t spill_head = 0;
+
+        AsyncState(size_t capacity, OverflowPolicy overflow)
+            : queue(capacity), policy(overflow) {}
+    };
+
     std::vector<TradeType> trades;
     std::unique_ptr<std::ofstream> log_file;
+    std::unique_ptr<TradeJournal> journal;
+    std::unique_ptr<AsyncState> async;
     std::string log_filename;
     bool batch_mode;
     size_t batch_size;
 
 public:
     explicit TradeLogger(const std::string& filename = "trades.log", 
-                        bool batch = true, size_t batch_sz = 1000)
+                        bool batch = true, size_t batch_sz = 1000,
+                        LogFormat format = LogFormat::Text)
         : log_filename(filename), batch_mode(batch), batch_size(batch_sz) {
+        // Binary mode appends straight into the mapping, so nothing is
+        // buffered and flush() only publishes the record count
+        if (format == LogFormat::Binary) {
+            journal = std::make_unique<TradeJournal>(filename);
+            if (journal->isOpen()) return;
+            journal.reset();  // mapping unavailable: fall back to text
+        }
+
         // Pre-allocate vector for performance
         trades.reserve(10000);
         
@@ -34,12 +81,9 @@ public:
         }
     }
 
-    // Destructor ensures file is flushed and closed (RAII)
+    // Destructor drains the writer thread, then flushes and closes (RAII)
     ~TradeLogger() {
-        flush();
-        if (log_file && log_file->is_open()) {
-            log_file->close();
-        }
+        close();
     }
 
     // Disable copy (unique ownership of file)
@@ -48,10 +92,50 @@ public:
 
     // Allow move
     TradeLogger(TradeLogger&&) noexcept = default;
-    TradeLogger& operator=(TradeLogger&&) noexcept = default;
+
+    TradeLogger& operator=(TradeLogger&& other) noexcept {
+        if (this != &other) {
+            // Our writer thread must be gone before its file is replaced
+            close();
+            trades = std::move(other.trades);
+            log_file = std::move(other.log_file);
+            journal = std::move(other.journal);
+            async = std::move(other.async);
+            log_filename = std::move(other.log_filename);
+            batch_mode = other.batch_mode;
+            batch_size = other.batch_size;
+        }
+        return *this;
+    }
+
+    // Switch to asynchronous logging. From here on logTrade() never touches
+    // the file; call from the thread that logs, before any other use.
+    void enableAsync(size_t queue_capacity = 65536,
+                     OverflowPolicy policy = OverflowPolicy::Block) {
+        if (async) return;
+        flush();
+        async = std::make_unique<AsyncState>(queue_capacity, policy);
+        AsyncState* state = async.get();
+        std::ofstream* file = (log_file && log_file->is_open()) ? log_file.get() : nullptr;
+        TradeJournal* binary = journal.get();
+        state->writer = std::thread([state, file, binary] { runWriter(*state, file, binary); });
+    }
+
+    bool isAsync() const { return async != nullptr; }
 
     // Log a single trade
     void logTrade(const TradeType& trade) {
+        if (async) {
+            enqueue(trade);
+            return;
+        }
+
+        if (journal) {
+            journal->append(toRecord(trade));
+            if (!batch_mode) journal->flush();
+            return;
+        }
+
         trades.push_back(trade);
         
         if (!batch_mode || trades.size() >= batch_size) {
@@ -61,6 +145,18 @@ public:
 
     // Log multiple trades
     void logTrades(const std::vector<TradeType>& new_trades) {
+        HFT_TRACE_ZONE("TradeLogger::logTrades");
+        if (async) {
+            for (const auto& trade : new_trades) enqueue(trade);
+            return;
+        }
+
+        if (journal) {
+            for (const auto& trade : new_trades) journal->append(toRecord(trade));
+            if (!batch_mode) journal->flush();
+            return;
+        }
+
         trades.insert(trades.end(), new_trades.begin(), new_trades.end());
         
         if (!batch_mode || trades.size() >= batch_size) {
@@ -68,14 +164,29 @@ public:
         }
     }
 
-    // Flush pending trades to file
+    // Flush pending trades to file. In async mode this waits until the
+    // writer has written everything enqueued so far.
     void flush() {
+        HFT_TRACE_ZONE("TradeLogger::flush");
+        if (async) {
+            drainSpill(true);
+            while (async->written.load(std::memory_order_acquire) < async->enqueued) {
+                std::this_thread::yield();
+            }
+            return;
+        }
+
+        if (journal) {
+            journal->flush();
+            return;
+        }
+
         if (!log_file || !log_file->is_open() || trades.empty()) {
             return;
         }
 
         for (const auto& trade : trades) {
-            writeTrade(trade);
+            writeTrade(*log_file, trade);
         }
 
         log_file->flush();
@@ -83,10 +194,25 @@ public:
     }
 
     // Get statistics
-    size_t getPendingCount() const { return trades.size(); }
+    size_t getPendingCount() const {
+        if (async) {
+            return static_cast<size_t>(async->enqueued - async->written.load(std::memory_order_acquire)) +
+                   (async->spill.size() - async->spill_head);
+        }
+        return trades.size();
+    }
+
+    // Trades discarded under OverflowPolicy::Drop, plus binary journal
+    // appends that failed because the file could not grow. Journal failures
+    // made by the async writer are included once flush() has returned.
+    uint64_t getDroppedCount() const {
+        return (async ? async->dropped : 0) + (journal ? journal->failedCount() : 0);
+    }
 
     const std::string& getFilename() const { return log_filename; }
 
+    LogFormat getFormat() const { return journal ? LogFormat::Binary : LogFormat::Text; }
+
 private:
     void writeHeader() {
         if (!log_file || !log_file->is_open()) return;
@@ -94,19 +220,119 @@ private:
         *log_file << "Timestamp,BuyOrderID,SellOrderID,Symbol,Price,Quantity\n";
     }
 
-    void writeTrade(const TradeType& trade) {
-        if (!log_file || !log_file->is_open()) return;
+    static void writeTrade(std::ofstream& out, const TradeType& trade) {
+        out << trade.timestamp_ns << ","
+            << trade.buy_order_id << ","
+            << trade.sell_order_id << ","
+            << symbolName(trade.symbol) << ","
+            << std::fixed << std::setprecision(2) << trade.price << ","
+            << trade.quantity << "\n";
+    }
+
+    static TradeRecord toRecord(const TradeType& trade) {
+        TradeRecord record;
+        record.timestamp_ns = trade.timestamp_ns;
+        record.buy_order_id = static_cast<int64_t>(trade.buy_order_id);
+        record.sell_order_id = static_cast<int64_t>(trade.sell_order_id);
+        record.price = static_cast<double>(trade.price);
+        record.symbol = trade.symbol;
+        record.quantity = trade.quantity;
+        return record;
+    }
+
+    // Hot path in async mode: one ring push unless the ring is full
+    void enqueue(const TradeType& trade) {
+        AsyncState& state = *async;
+
+        if (state.policy == OverflowPolicy::Spill && state.spill_head < state.spill.size()) {
+            // Keep ordering: nothing new enters the ring before the spill
+            drainSpill(false);
+            if (state.spill_head < state.spill.size()) {
+                state.spill.push_back(trade);
+                return;
+            }
+        }
+
+        if (state.queue.tryPush(trade)) {
+            ++state.enqueued;
+            return;
+        }
+
+        switch (state.policy) {
+        case OverflowPolicy::Block:
+            while (!state.queue.tryPush(trade)) std::this_thread::yield();
+            ++state.enqueued;
+            break;
+        case OverflowPolicy::Drop:
+            ++state.dropped;
+            break;
+        case OverflowPolicy::Spill:
+            state.spill.push_back(trade);
+            break;
+        }
+    }
 
-        auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            trade.timestamp.time_since_epoch()
-        ).count();
+    // Move spilled trades into the ring; with wait=true, until none remain
+    void drainSpill(bool wait) {
+        AsyncState& state = *async;
+        while (state.spill_head < state.spill.size()) {
+            if (state.queue.tryPush(state.spill[state.spill_head])) {
+                ++state.spill_head;
+                ++state.enqueued;
+            } else if (wait) {
+                std::this_thread::yield();
+            } else {
+                return;
+            }
+        }
+        state.spill.clear();
+        state.spill_head = 0;
+    }
 
-        *log_file << time_ns << ","
-                 << trade.buy_order_id << ","
-                 << trade.sell_order_id << ","
-                 << trade.symbol << ","
-                 << std::fixed << std::setprecision(2) << trade.price << ","
-                 << trade.quantity << "\n";
+    // Stop the writer (after it has drained the ring), then flush and close
+    void close() {
+        if (async) {
+            flush();
+            async->running.store(false, std::memory_order_release);
+            if (async->writer.joinable()) async->writer.join();
+            async.reset();
+        }
+        flush();
+        if (journal) journal->close();
+        if (log_file && log_file->is_open()) {
+            log_file->close();
+        }
+    }
+
+    static void runWriter(AsyncState& state, std::ofstream* file, TradeJournal* journal) {
+        constexpr size_t max_batch = 4096;
+        uint64_t done = 0;
+        TradeType trade;
+
+        while (true) {
+            size_t n = 0;
+            while (n < max_batch && state.queue.tryPop(trade)) {
+                if (journal) {
+                    journal->append(toRecord(trade));
+                } else if (file) {
+                    writeTrade(*file, trade);
+                }
+                ++n;
+            }
+            done += n;
+            if (n == max_batch) continue;  // more waiting, keep draining
+
+            // Ring is empty: push the batch out, then publish progress
+            if (n > 0) {
+                HFT_TRACE_ZONE("TradeLogger::flushBatch");
+                if (journal) journal->flush();
+                if (file) file->flush();
+                state.written.store(done, std::memory_order_release);
+                continue;
+            }
+            if (!state.running.load(std::memory_order_acquire) && state.queue.empty()) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
     }
 
 public:
@@ -123,9 +349,9 @@ public:
         // Calculate total volume
         long long total_volume = 0;
         double total_value = 0.0;
-        for (const auto& trade : all_trades) {
+        for (const TradeType& trade : all_trades) {
             total_volume += trade.quantity;
-            total_value += trade.price * trade.quantity;
+            total_value += static_cast<double>(trade.price) * trade.quantity;
         }
 
         oss << "Total Volume: " << total_volume << " shares\n";
@@ -135,6 +361,10 @@ public:
             oss << "Average Price: $" << (total_value / total_volume) << "\n";
         }
 
+        if (uint64_t dropped = getDroppedCount()) {
+            oss << "Dropped (not logged): " << dropped << " trades\n";
+        }
+
         oss << "===================\n";
         return oss.str();
     }
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// How a consumer thread waits for work (OrderGateway's matching thread).
+// wait(ready) returns once ready() is true; producers call notify() after
+// publishing work, and wakeAll() forces a re-check (e.g. on shutdown).
+
+namespace wait_detail {
+
+// Spin-loop hint: lets the sibling hyperthread run and saves power
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+}  // namespace wait_detail
+
+// Busy-spin: lowest wake-up latency, but the waiting thread owns a core
+struct SpinWait {
+    static constexpr const char* name = "spin";
+
+    template <typename Ready>
+    void wait(Ready&& ready) {
+        while (!ready()) wait_detail::cpuRelax();
+    }
+
+    void notify() {}
+    void wakeAll() {}
+};
+
+// Spin briefly, then park on a condition variable. Producers only take the
+// mutex when the consumer is actually parked, so an active consumer costs
+// them one extra load per publish.
+class ParkWait {
+public:
+    static constexpr const char* name = "park";
+
+    explicit ParkWait(unsigned spins = 4096) : spin_limit(spins) {}
+
+    template <typename Ready>
+    void wait(Ready&& ready) {
+        for (unsigned i = 0; i < spin_limit; ++i) {
+            if (ready()) return;
+            wait_detail::cpuRelax();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        parked.store(true, std::memory_order_relaxed);
+        // Pairs with the fence in notify(): either the producer sees parked,
+        // or this thread sees its work in ready()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wakeup.wait(lock, ready);
+        parked.store(false, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!parked.load(std::memory_order_relaxed)) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeup.notify_one();
+    }
+
+    void wakeAll() {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeup.notify_all();
+    }
+
+private:
+    unsigned spin_limit;
+    std::atomic<bool> parked{false};
+    std::mutex mutex;
+    std::condition_variable wakeup;
+};
@@ -0,0 +1,23 @@
+#include "../include/AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Kept in its own translation unit: with the replacements visible next to
+// new/delete expressions, GCC pairs the inlined malloc/free against them
+// and warns (-Wmismatched-new-delete) in optimized builds.
+
+static std::atomic<size_t> g_allocation_count{0};
+
+void* operator new(std::size_t size) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+size_t allocationCount() {
+    return g_allocation_count.load(std::memory_order_relaxed);
+}
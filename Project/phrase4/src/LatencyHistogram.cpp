@@ -0,0 +1,116 @@
+#include "../include/LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+LatencyHistogram::LatencyHistogram(int significant_digits, int64_t highest)
+    : digits(std::min(std::max(significant_digits, 1), 5)),
+      highest_trackable(std::max<int64_t>(highest, 2)) {
+    // Enough linear sub-buckets that one step is below 10^-digits of the
+    // smallest value in a bucket (the lower half of each bucket is shared
+    // with the previous one, hence the factor 2)
+    uint64_t needed = 2;
+    for (int i = 0; i < digits; ++i) needed *= 10;
+    sub_bucket_bits = log2Floor(needed - 1) + 1;
+    sub_bucket_mask = (uint64_t{1} << sub_bucket_bits) - 1;
+
+    counts.assign(indexFor(highest_trackable) + 1, 0);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.digits != digits || other.highest_trackable != highest_trackable) {
+        throw std::invalid_argument("LatencyHistogram::merge: configurations differ");
+    }
+    if (other.total_count == 0) return;
+
+    for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    total_count += other.total_count;
+    min_value = std::min(min_value, other.min_value);
+    max_value = std::max(max_value, other.max_value);
+    sum += other.sum;
+    sum_squares += other.sum_squares;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total_count = 0;
+    min_value = INT64_MAX;
+    max_value = 0;
+    sum = 0.0;
+    sum_squares = 0.0;
+}
+
+double LatencyHistogram::mean() const {
+    return total_count ? sum / total_count : 0.0;
+}
+
+double LatencyHistogram::stddev() const {
+    if (total_count == 0) return 0.0;
+    double m = mean();
+    return std::sqrt(std::max(0.0, sum_squares / total_count - m * m));
+}
+
+int64_t LatencyHistogram::percentile(double p) const {
+    if (total_count == 0) return 0;
+    if (p >= 100.0) return max_value;
+
+    // Rank of the sample at this percentile (1-based, at least the first)
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::max(p, 0.0) / 100.0 * total_count));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(highestEquivalent(i), max_value);
+    }
+    return max_value;
+}
+
+int64_t LatencyHistogram::lowestEquivalent(size_t index) const {
+    size_t half = static_cast<size_t>(sub_bucket_mask + 1) >> 1;
+    int bucket = index < 2 * half ? 0 : static_cast<int>(index / half) - 1;
+    uint64_t sub = index - (static_cast<size_t>(bucket) * half);
+    return static_cast<int64_t>(sub << bucket);
+}
+
+int64_t LatencyHistogram::highestEquivalent(size_t index) const {
+    size_t half = static_cast<size_t>(sub_bucket_mask + 1) >> 1;
+    int bucket = index < 2 * half ? 0 : static_cast<int>(index / half) - 1;
+    return lowestEquivalent(index) + (int64_t{1} << bucket) - 1;
+}
+
+bool LatencyHistogram::exportDistribution(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    out << std::setw(12) << "Value" << " " << std::setw(14) << "Percentile" << " "
+        << std::setw(10) << "TotalCount" << " " << std::setw(14) << "1/(1-Percentile)" << "\n\n";
+    out << std::fixed;
+
+    // One row per occupied bucket (recorded-values iteration)
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size() && seen < total_count; ++i) {
+        if (counts[i] == 0) continue;
+        seen += counts[i];
+        double fraction = static_cast<double>(seen) / total_count;
+        out << std::setw(12) << std::setprecision(3)
+            << static_cast<double>(std::min(highestEquivalent(i), max_value)) << " "
+            << std::setw(14) << std::setprecision(12) << fraction << " "
+            << std::setw(10) << seen << " ";
+        if (seen < total_count) {
+            out << std::setw(14) << std::setprecision(2) << 1.0 / (1.0 - fraction) << "\n";
+        } else {
+            out << std::setw(14) << "inf" << "\n";
+        }
+    }
+
+    out << std::setprecision(3)
+        << "#[Mean    = " << std::setw(12) << mean() << ", StdDeviation   = " << std::setw(12) << stddev() << "]\n"
+        << "#[Max     = " << std::setw(12) << static_cast<double>(max()) << ", Total count    = "
+        << std::setw(12) << total_count << "]\n"
+        << "#[Buckets = " << std::setw(12) << ((counts.size() - 1) >> (sub_bucket_bits - 1))
+        << ", SubBuckets     = " << std::setw(12) << (sub_bucket_mask + 1) << "]\n";
+    return static_cast<bool>(out);
+}
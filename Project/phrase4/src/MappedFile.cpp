@@ -0,0 +1,175 @@
+#include "../include/MappedFile.hpp"
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if !defined(_WIN32)
+
+MappedRecordWriter::MappedRecordWriter(const std::string& path, const char (&magic)[8],
+                                       uint32_t version, uint32_t record_size, size_t chunk_bytes)
+    : file_path(path), chunk(std::max<size_t>(chunk_bytes, sizeof(MappedFileHeader) + record_size)),
+      fd(-1), base(nullptr), mapped_bytes(0),
+      write_offset(sizeof(MappedFileHeader)), record_count(0), failed_count(0) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+
+    if (!grow()) {
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+
+    MappedFileHeader header{};
+    std::memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = version;
+    header.record_size = record_size;
+    std::memcpy(base, &header, sizeof(header));
+}
+
+MappedRecordWriter::~MappedRecordWriter() {
+    close();
+}
+
+void MappedRecordWriter::flush() {
+    if (!base) return;
+    reinterpret_cast<MappedFileHeader*>(base)->record_count = record_count;
+}
+
+void MappedRecordWriter::close() {
+    if (fd < 0) return;
+
+    if (base) {
+        flush();
+        munmap(base, mapped_bytes);
+        base = nullptr;
+    }
+
+    // Symbol table goes right after the last record; the file is then
+    // exactly header + records + table
+    std::string table;
+    auto& registry = SymbolRegistry::instance();
+    uint64_t symbol_count = registry.size();
+    for (SymbolId id = 0; id < symbol_count; ++id) {
+        const std::string& name = registry.name(id);
+        uint32_t length = static_cast<uint32_t>(name.size());
+        table.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        table.append(name);
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(write_offset)) == 0 &&
+        pwrite(fd, table.data(), table.size(), static_cast<off_t>(write_offset)) ==
+            static_cast<ssize_t>(table.size())) {
+        uint64_t table_offset = write_offset;
+        pwrite(fd, &table_offset, sizeof(table_offset),
+               offsetof(MappedFileHeader, symbol_table_offset));
+        pwrite(fd, &symbol_count, sizeof(symbol_count),
+               offsetof(MappedFileHeader, symbol_count));
+    }
+
+    ::close(fd);
+    fd = -1;
+}
+
+bool MappedRecordWriter::grow() {
+    size_t new_size = mapped_bytes + chunk;
+    if (ftruncate(fd, static_cast<off_t>(new_size)) != 0) return false;
+
+    // Only sequential appends touch the mapping, so a fresh map of the
+    // larger file replaces the old one (no mremap dependency)
+    void* mapping = mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) return false;
+
+    if (base) munmap(base, mapped_bytes);
+    base = static_cast<char*>(mapping);
+    mapped_bytes = new_size;
+    return true;
+}
+
+MappedRecordReader::MappedRecordReader(const std::string& path, const char (&magic)[8],
+                                       uint32_t record_size)
+    : fd(-1), base(nullptr), file_bytes(0), record_count(0) {
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(MappedFileHeader)) {
+        return;
+    }
+    file_bytes = static_cast<size_t>(info.st_size);
+
+    // Readers walk the whole file, so fault it in up front in one go
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* mapping = mmap(nullptr, file_bytes, PROT_READ, flags, fd, 0);
+    if (mapping == MAP_FAILED) return;
+
+    MappedFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0 ||
+        header.record_size != record_size) {
+        munmap(mapping, file_bytes);
+        return;
+    }
+    base = static_cast<const char*>(mapping);
+
+    // Never trust the count beyond what the file actually holds
+    uint64_t available = (file_bytes - sizeof(MappedFileHeader)) / record_size;
+    record_count = std::min(header.record_count, available);
+
+    if (header.symbol_table_offset != 0) {
+        size_t pos = header.symbol_table_offset;
+        for (uint64_t i = 0; i < header.symbol_count; ++i) {
+            uint32_t length;
+            if (pos + sizeof(length) > file_bytes) break;
+            std::memcpy(&length, base + pos, sizeof(length));
+            pos += sizeof(length);
+            if (pos + length > file_bytes) break;
+            symbols.emplace_back(base + pos, length);
+            pos += length;
+        }
+    }
+}
+
+MappedRecordReader::~MappedRecordReader() {
+    if (base) munmap(const_cast<char*>(base), file_bytes);
+    if (fd >= 0) ::close(fd);
+}
+
+#else
+
+// Memory mapping is only implemented for POSIX; on Windows the files stay
+// closed (TradeLogger keeps writing text, recording is unavailable)
+MappedRecordWriter::MappedRecordWriter(const std::string& path, const char (&)[8],
+                                       uint32_t, uint32_t, size_t chunk_bytes)
+    : file_path(path), chunk(chunk_bytes), fd(-1), base(nullptr), mapped_bytes(0),
+      write_offset(0), record_count(0), failed_count(0) {}
+MappedRecordWriter::~MappedRecordWriter() {}
+void MappedRecordWriter::flush() {}
+void MappedRecordWriter::close() {}
+bool MappedRecordWriter::grow() { return false; }
+
+MappedRecordReader::MappedRecordReader(const std::string&, const char (&)[8], uint32_t)
+    : fd(-1), base(nullptr), file_bytes(0), record_count(0) {}
+MappedRecordReader::~MappedRecordReader() {}
+
+#endif
+
+const std::string& MappedRecordReader::symbol(uint32_t id) const {
+    static const std::string unknown;
+    return id < symbols.size() ? symbols[id] : unknown;
+}
+
+std::vector<SymbolId> MappedRecordReader::internSymbols() const {
+    std::vector<SymbolId> ids(symbols.size(), 0);
+    for (size_t i = 1; i < ids.size(); ++i) {
+        ids[i] = internSymbol(symbols[i]);
+    }
+    return ids;
+}
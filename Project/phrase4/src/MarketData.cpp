@@ -1,36 +1,119 @@
 #include "../include/MarketData.hpp"
 #include <random>
+#include <cstring>
 
-MarketDataFeed::MarketDataFeed(double base_price)
-    : rng(std::random_device{}()),
-      price_dist(-5.0, 5.0),  // Price variation range
-      size_dist(50, 500)      // Size variation range
-{
+namespace {
+
+// Price walk and size ranges shared by the scalar and batch paths
+constexpr double price_step = 0.1;       // walk step is uniform(-5, 5) * price_step
+constexpr double min_spread = 0.01;      // spread is uniform(0.01, 0.02)
+constexpr double spread_range = 0.01;
+constexpr int min_size = 50;             // sizes are uniform in [50, 500]
+constexpr uint32_t size_range = 451;
+constexpr double reset_price = 100.0;    // walk restarts here if it drops below 1.0
+
+constexpr double unit_scale = 1.0 / 4294967296.0;  // 2^-32
+
+inline double unitInterval(uint32_t r) { return r * unit_scale; }
+
+inline int sizeFrom(uint32_t r) {
+    return min_size + static_cast<int>((static_cast<uint64_t>(r) * size_range) >> 32);
 }
 
-MarketData MarketDataFeed::generateTick(const std::string& symbol) {
-    static double base_price = 150.0;
-    
-    // Generate random price movements
-    double price_change = price_dist(rng);
-    base_price += price_change * 0.1; // Small incremental changes
-    
-    // Ensure positive prices
-    if (base_price < 1.0) base_price = 100.0;
-    
-    // Generate bid-ask spread (typically 0.01 to 0.05)
-    double spread = 0.01 + (price_dist(rng) + 5.0) / 1000.0;
-    
-    double bid = base_price - spread / 2.0;
-    double ask = base_price + spread / 2.0;
-    
-    int bid_size = size_dist(rng);
-    int ask_size = size_dist(rng);
-    
-    return MarketData(symbol, bid, ask, bid_size, ask_size);
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
 }
 
-std::vector<MarketData> MarketDataFeed::generateTicks(const std::string& symbol, int count) {
+inline double stepWalk(double mid, uint32_t r) {
+    mid += (unitInterval(r) * 10.0 - 5.0) * price_step;
+    return mid < 1.0 ? reset_price : mid;
+}
+
+}  // namespace
+
+LaneRng::LaneRng(uint64_t seed) {
+    uint64_t state = seed;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        uint64_t a = splitmix64(state);
+        uint64_t b = splitmix64(state);
+        s0[lane] = static_cast<uint32_t>(a);
+        s1[lane] = static_cast<uint32_t>(a >> 32);
+        s2[lane] = static_cast<uint32_t>(b);
+        s3[lane] = static_cast<uint32_t>(b >> 32) | 1u;  // never all-zero
+    }
+}
+
+void LaneRng::fill(uint32_t* out, size_t count) {
+    size_t i = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    // Explicit 8 x 32-bit vectors (one AVX2 register, or two SSE2 ones);
+    // autovectorizing the lane loop is not reliable across compilers
+    typedef uint32_t Lanes __attribute__((vector_size(lanes * sizeof(uint32_t))));
+    Lanes a, b, c, d;
+    std::memcpy(&a, s0, sizeof(a));
+    std::memcpy(&b, s1, sizeof(b));
+    std::memcpy(&c, s2, sizeof(c));
+    std::memcpy(&d, s3, sizeof(d));
+    for (; i + lanes <= count; i += lanes) {
+        Lanes result = a + d;
+        Lanes t = b << 9;
+        c ^= a;
+        d ^= b;
+        b ^= c;
+        a ^= d;
+        c ^= t;
+        d = (d << 11) | (d >> 21);
+        std::memcpy(out + i, &result, sizeof(result));
+    }
+    std::memcpy(s0, &a, sizeof(a));
+    std::memcpy(s1, &b, sizeof(b));
+    std::memcpy(s2, &c, sizeof(c));
+    std::memcpy(s3, &d, sizeof(d));
+#else
+    for (; i + lanes <= count; i += lanes) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            uint32_t t = s1[lane] << 9;
+            out[i + lane] = s0[lane] + s3[lane];
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = (s3[lane] << 11) | (s3[lane] >> 21);
+        }
+    }
+#endif
+
+    if (i < count) {
+        uint32_t tail[lanes];
+        fill(tail, lanes);
+        std::memcpy(out + i, tail, (count - i) * sizeof(uint32_t));
+    }
+}
+
+MarketDataFeed::MarketDataFeed(double base)
+    : MarketDataFeed(base, (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}()) {}
+
+MarketDataFeed::MarketDataFeed(double base, uint64_t seed)
+    : rng(seed), base_price(base > 0.0 ? base : 150.0) {}
+
+MarketData MarketDataFeed::generateTick(SymbolId symbol) {
+    double& mid = midFor(symbol);
+    mid = stepWalk(mid, rng.next());
+
+    // Generate bid-ask spread (0.01 to 0.02)
+    double spread = min_spread + unitInterval(rng.next()) * spread_range;
+
+    int bid_size = sizeFrom(rng.next());
+    int ask_size = sizeFrom(rng.next());
+
+    return MarketData(symbol, mid - spread / 2.0, mid + spread / 2.0, bid_size, ask_size);
+}
+
+std::vector<MarketData> MarketDataFeed::generateTicks(SymbolId symbol, int count) {
     std::vector<MarketData> ticks;
     ticks.reserve(count);
     
@@ -40,3 +123,60 @@ std::vector<MarketData> MarketDataFeed::generateTicks(const std::string& symbol,
     
     return ticks;
 }
+
+void MarketDataFeed::generateBatch(const SymbolId* symbols, size_t num_symbols,
+                                   size_t count, TickBatch& out) {
+    out.resize(count);
+    out.timestamp = std::chrono::high_resolution_clock::now();
+    if (count == 0 || num_symbols == 0) {
+        out.resize(0);
+        return;
+    }
+
+    // All random draws first, as four column-ordered blocks
+    scratch.resize(count * 4);
+    rng.fill(scratch.data(), scratch.size());
+    const uint32_t* steps = scratch.data();
+    const uint32_t* spreads = steps + count;
+    const uint32_t* bid_sizes = spreads + count;
+    const uint32_t* ask_sizes = bid_sizes + count;
+
+    // Independent columns: straight-line loops over contiguous arrays
+    for (size_t i = 0; i < count; ++i) {
+        out.bid_size[i] = sizeFrom(bid_sizes[i]);
+        out.ask_size[i] = sizeFrom(ask_sizes[i]);
+        out.ask_price[i] = (min_spread + unitInterval(spreads[i]) * spread_range) / 2.0;  // half spread
+    }
+
+    // The walks are sequential per symbol. A single symbol keeps its mid in
+    // a register; several are interleaved through a small local array.
+    if (num_symbols == 1) {
+        double mid = midFor(symbols[0]);
+        for (size_t i = 0; i < count; ++i) {
+            mid = stepWalk(mid, steps[i]);
+            double half_spread = out.ask_price[i];
+            out.symbol[i] = symbols[0];
+            out.bid_price[i] = mid - half_spread;
+            out.ask_price[i] = mid + half_spread;
+        }
+        midFor(symbols[0]) = mid;
+        return;
+    }
+
+    std::vector<double>& mids = batch_mids;
+    mids.resize(num_symbols);
+    for (size_t k = 0; k < num_symbols; ++k) mids[k] = midFor(symbols[k]);
+
+    size_t s = 0;
+    for (size_t i = 0; i < count; ++i) {
+        double mid = stepWalk(mids[s], steps[i]);
+        mids[s] = mid;
+        double half_spread = out.ask_price[i];
+        out.symbol[i] = symbols[s];
+        out.bid_price[i] = mid - half_spread;
+        out.ask_price[i] = mid + half_spread;
+        if (++s == num_symbols) s = 0;
+    }
+
+    for (size_t k = 0; k < num_symbols; ++k) midFor(symbols[k]) = mids[k];
+}
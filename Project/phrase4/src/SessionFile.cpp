@@ -0,0 +1,30 @@
+#include "../include/SessionFile.hpp"
+#include "../include/Timer.hpp"
+
+SessionRecorder::SessionRecorder(const std::string& path)
+    : file(path, session_format::magic, session_format::version, sizeof(SessionEvent)),
+      start_ns(timer_detail::steadyNs()) {}
+
+void SessionRecorder::recordTick(const MarketData& tick) {
+    SessionEvent event{};
+    event.timestamp_ns = static_cast<int64_t>(timer_detail::steadyNs() - start_ns);
+    event.bid_price = tick.bid_price;
+    event.ask_price = tick.ask_price;
+    event.symbol = tick.symbol;
+    event.bid_size = tick.bid_size;
+    event.ask_size = tick.ask_size;
+    event.type = static_cast<uint8_t>(SessionEventType::Tick);
+    file.append(event);
+}
+
+void SessionRecorder::recordOrder(SymbolId symbol, double price, int quantity, bool is_buy,
+                                  SessionEventType type) {
+    SessionEvent event{};
+    event.timestamp_ns = static_cast<int64_t>(timer_detail::steadyNs() - start_ns);
+    event.price = price;
+    event.symbol = symbol;
+    event.quantity = quantity;
+    event.type = static_cast<uint8_t>(type);
+    event.is_buy = is_buy ? 1 : 0;
+    file.append(event);
+}
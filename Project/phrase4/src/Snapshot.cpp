@@ -0,0 +1,41 @@
+#include "../include/Snapshot.hpp"
+#include "../include/Timer.hpp"
+
+bool SnapshotWriter::writeFile(const std::string& path, const std::vector<SnapshotRecord>& records) {
+    // One mapping sized for the whole snapshot, so the file never regrows
+    size_t bytes = sizeof(MappedFileHeader) + records.size() * sizeof(SnapshotRecord);
+    MappedRecordWriter file(path, snapshot_format::magic, snapshot_format::version,
+                            sizeof(SnapshotRecord), bytes);
+    if (!file.isOpen()) return false;
+
+    for (const SnapshotRecord& record : records) file.append(record);
+    bool complete = file.recordCount() == records.size();
+    file.close();
+    return complete;
+}
+
+void SnapshotWriter::writeAsync(const std::string& path, std::vector<SnapshotRecord> records) {
+    wait();
+    file_path = path;
+    pending = std::move(records);
+    record_count = pending.size();
+    succeeded = false;
+    worker = std::thread([this] {
+        uint64_t start = timer_detail::steadyNs();
+        succeeded = writeFile(file_path, pending);
+        write_ns = timer_detail::steadyNs() - start;
+    });
+}
+
+bool SnapshotWriter::wait() {
+    if (worker.joinable()) worker.join();
+    return succeeded;
+}
+
+std::vector<SnapshotRecord> SnapshotWriter::takeBuffer() {
+    wait();
+    std::vector<SnapshotRecord> buffer;
+    buffer.swap(pending);
+    buffer.clear();
+    return buffer;
+}
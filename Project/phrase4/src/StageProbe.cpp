@@ -0,0 +1,159 @@
+#include "../include/StageProbe.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <ios>
+#include <mutex>
+
+namespace stage_probe {
+
+namespace {
+
+// Stage names plus every live thread's ring; histograms of exited threads
+// are merged into `retired`
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<ThreadRing*> rings;
+    std::vector<LatencyHistogram> retired;
+    size_t retired_overwritten = 0;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+void mergeInto(std::vector<LatencyHistogram>& target, const std::vector<LatencyHistogram>& source) {
+    if (target.size() < source.size()) target.resize(source.size());
+    for (size_t i = 0; i < source.size(); ++i) target[i].merge(source[i]);
+}
+
+}  // namespace
+
+StageId registerStage(const char* name) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (size_t i = 0; i < reg.names.size(); ++i) {
+        if (reg.names[i] == name) return static_cast<StageId>(i);
+    }
+    reg.names.emplace_back(name);
+    return static_cast<StageId>(reg.names.size() - 1);
+}
+
+ThreadRing::ThreadRing() : raw_tsc(backend.usingTsc()), samples(new Sample[capacity]) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.rings.push_back(this);
+}
+
+ThreadRing::~ThreadRing() {
+    fold();
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    mergeInto(reg.retired, stage_histograms);
+    reg.retired_overwritten += overwritten_samples;
+    reg.rings.erase(std::remove(reg.rings.begin(), reg.rings.end(), this), reg.rings.end());
+}
+
+void ThreadRing::fold() {
+    // Only the last `capacity` samples survive a wrap
+    uint64_t first = recorded - folded > capacity ? recorded - capacity : folded;
+    overwritten_samples += static_cast<size_t>(first - folded);
+    for (uint64_t i = first; i < recorded; ++i) {
+        const Sample& sample = samples[i & (capacity - 1)];
+        if (sample.stage >= stage_histograms.size()) stage_histograms.resize(sample.stage + 1);
+        long long ns = sample.stop > sample.start ? backend.toNanoseconds(sample.stop - sample.start) : 0;
+        stage_histograms[sample.stage].record(ns);
+    }
+    folded = recorded;
+}
+
+void ThreadRing::clear() {
+    folded = recorded;
+    overwritten_samples = 0;
+    for (LatencyHistogram& histogram : stage_histograms) histogram.reset();
+}
+
+std::vector<StageStats> collect() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    std::vector<LatencyHistogram> merged;
+    mergeInto(merged, reg.retired);
+    for (ThreadRing* ring : reg.rings) {
+        ring->fold();
+        mergeInto(merged, ring->histograms());
+    }
+
+    std::vector<StageStats> stats;
+    for (size_t i = 0; i < merged.size() && i < reg.names.size(); ++i) {
+        if (!merged[i].empty()) stats.push_back(StageStats{reg.names[i], merged[i]});
+    }
+    return stats;
+}
+
+void reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (LatencyHistogram& histogram : reg.retired) histogram.reset();
+    reg.retired_overwritten = 0;
+    for (ThreadRing* ring : reg.rings) ring->clear();
+}
+
+size_t overwrittenSamples() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t total = reg.retired_overwritten;
+    for (ThreadRing* ring : reg.rings) {
+        ring->fold();
+        total += ring->overwritten();
+    }
+    return total;
+}
+
+bool enabled() {
+#if defined(HFT_STAGE_PROBES)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void printReport(std::ostream& out, const std::string& title) {
+    if (!enabled()) {
+        out << "Stage breakdown: probes compiled out (HFT_STAGE_PROBES=OFF)\n";
+        return;
+    }
+    std::vector<StageStats> stats = collect();
+    if (stats.empty()) return;
+
+    // Share of the total time spent across all probed stages
+    double total_ns = 0.0;
+    for (const StageStats& stage : stats) total_ns += stage.latency.mean() * stage.latency.count();
+
+    // Formatting below is local to the report; give the caller its stream back as it was
+    std::ios saved_format(nullptr);
+    saved_format.copyfmt(out);
+
+    out << "\nStage breakdown - " << title << " (ns):\n";
+    out << std::left << std::setw(12) << "Stage" << std::right << std::setw(10) << "Count"
+        << std::setw(9) << "Mean" << std::setw(8) << "P50" << std::setw(8) << "P90"
+        << std::setw(8) << "P99" << std::setw(9) << "P99.9" << std::setw(10) << "Max"
+        << std::setw(8) << "Share" << "\n";
+    out << std::string(82, '-') << "\n";
+    for (const StageStats& stage : stats) {
+        const LatencyHistogram& h = stage.latency;
+        double share = total_ns > 0.0 ? 100.0 * h.mean() * h.count() / total_ns : 0.0;
+        out << std::left << std::setw(12) << stage.name << std::right << std::setw(10) << h.count()
+            << std::setw(9) << std::fixed << std::setprecision(0) << h.mean()
+            << std::setw(8) << h.percentile(50.0) << std::setw(8) << h.percentile(90.0)
+            << std::setw(8) << h.percentile(99.0) << std::setw(9) << h.percentile(99.9)
+            << std::setw(10) << h.max() << std::setw(7) << std::setprecision(1) << share << "%\n";
+    }
+    if (size_t lost = overwrittenSamples()) {
+        out << lost << " samples overwritten before folding (add HFT_PROBE_DRAIN() to the loop)\n";
+    }
+    out.copyfmt(saved_format);
+}
+
+}  // namespace stage_probe
@@ -0,0 +1,35 @@
+#include "../include/Symbol.hpp"
+
+SymbolRegistry& SymbolRegistry::instance() {
+    static SymbolRegistry registry;
+    return registry;
+}
+
+SymbolRegistry::SymbolRegistry() {
+    names.emplace_back("");
+    ids.emplace("", 0);
+}
+
+SymbolId SymbolRegistry::intern(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = ids.find(symbol);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    SymbolId id = static_cast<SymbolId>(names.size());
+    names.push_back(symbol);
+    ids.emplace(symbol, id);
+    return id;
+}
+
+const std::string& SymbolRegistry::name(SymbolId id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (id < names.size()) ? names[id] : names[0];
+}
+
+size_t SymbolRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return names.size();
+}
@@ -0,0 +1,65 @@
+#include "../include/Timer.hpp"
+
+#if HFT_TSC_AVAILABLE && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace timer_detail {
+
+namespace {
+
+bool invariantTsc() {
+#if HFT_TSC_AVAILABLE
+    // CPUID leaf 0x80000007, EDX bit 8: invariant TSC
+    unsigned int regs[4] = {0, 0, 0, 0};
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if (static_cast<unsigned int>(info[0]) < 0x80000007u) return false;
+    __cpuid(info, 0x80000007);
+    regs[3] = static_cast<unsigned int>(info[3]);
+#else
+    if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+    __get_cpuid(0x80000007u, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+    return (regs[3] & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+TscCalibration calibrate() {
+    TscCalibration result{false, invariantTsc(), 1.0};
+#if HFT_TSC_AVAILABLE
+    if (!result.invariant) return result;
+
+    // Count ticks across a ~10 ms steady_clock window
+    const uint64_t window_ns = 10000000;
+    uint64_t ns_start = steadyNs();
+    uint64_t ticks_start = tscBegin();
+    uint64_t ns_end;
+    do {
+        ns_end = steadyNs();
+    } while (ns_end - ns_start < window_ns);
+    uint64_t ticks_end = tscEnd();
+
+    if (ticks_end <= ticks_start) return result;
+    double ns_per_tick = static_cast<double>(ns_end - ns_start) / (ticks_end - ticks_start);
+
+    // Reject anything outside 100 MHz - 20 GHz
+    if (ns_per_tick < 0.05 || ns_per_tick > 10.0) return result;
+
+    result.usable = true;
+    result.ns_per_tick = ns_per_tick;
+#endif
+    return result;
+}
+
+}  // namespace
+
+const TscCalibration& tscCalibration() {
+    static const TscCalibration calibration = calibrate();
+    return calibration;
+}
+
+}  // namespace timer_detail
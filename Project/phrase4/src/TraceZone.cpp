@@ -0,0 +1,137 @@
+#include "../include/TraceZone.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+namespace trace_detail {
+
+std::atomic<bool> g_active{false};
+
+namespace {
+
+// Every thread that recorded a zone, plus the current session. The stamp
+// pair taken at start() and stop() converts cycle counts to microseconds.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::string path;
+    uint64_t start_stamp = 0;
+    uint64_t start_ns = 0;
+    size_t written = 0;
+    size_t overwritten = 0;
+    bool exit_hook = false;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+void writeEscaped(std::FILE* out, const char* text) {
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\') std::fputc('\\', out);
+        std::fputc(*text, out);
+    }
+}
+
+// Chrome trace-event JSON: one complete ("X") event per zone, times in us
+bool writeTrace(Registry& reg, double us_per_stamp) {
+    std::FILE* out = std::fopen(reg.path.c_str(), "w");
+    if (!out) return false;
+
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", out);
+    std::fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"hft\"}}", out);
+    for (const auto& buffer : reg.buffers) {
+        uint64_t first = buffer->head > ThreadBuffer::capacity ? buffer->head - ThreadBuffer::capacity : 0;
+        reg.overwritten += static_cast<size_t>(first);
+        for (uint64_t i = first; i < buffer->head; ++i) {
+            const Event& event = buffer->events[i & (ThreadBuffer::capacity - 1)];
+            if (event.begin < reg.start_stamp || event.end < event.begin) continue;
+            std::fputs(",\n{\"name\":\"", out);
+            writeEscaped(out, event.name);
+            std::fprintf(out, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         buffer->tid, (event.begin - reg.start_stamp) * us_per_stamp,
+                         (event.end - event.begin) * us_per_stamp);
+            ++reg.written;
+        }
+    }
+    std::fputs("\n]}\n", out);
+    return std::fclose(out) == 0;
+}
+
+void stopAtExit() {
+    if (trace::active()) trace::stop();
+}
+
+}  // namespace
+
+ThreadBuffer* registerThread() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+    reg.buffers.back()->tid = static_cast<uint32_t>(reg.buffers.size());
+    return reg.buffers.back().get();
+}
+
+}  // namespace trace_detail
+
+namespace trace {
+
+using trace_detail::g_active;
+using trace_detail::registry;
+
+bool start(const std::string& path) {
+    trace_detail::Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (g_active.load(std::memory_order_relaxed)) return false;
+
+    reg.path = path;
+    for (auto& buffer : reg.buffers) buffer->head = 0;
+    reg.written = 0;
+    reg.overwritten = 0;
+    if (!reg.exit_hook) {
+        std::atexit(trace_detail::stopAtExit);
+        reg.exit_hook = true;
+    }
+    reg.start_ns = timer_detail::steadyNs();
+    reg.start_stamp = trace_detail::stamp();
+    g_active.store(true, std::memory_order_release);
+    return true;
+}
+
+bool stop() {
+    if (!g_active.exchange(false, std::memory_order_acq_rel)) return false;
+    uint64_t stop_stamp = trace_detail::stamp();
+    uint64_t stop_ns = timer_detail::steadyNs();
+
+    trace_detail::Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    // Calibrated over the session itself; stamps are already ns without a TSC
+    double us_per_stamp = 1e-3;
+#if HFT_TSC_AVAILABLE
+    if (stop_stamp > reg.start_stamp) {
+        us_per_stamp = static_cast<double>(stop_ns - reg.start_ns) / (stop_stamp - reg.start_stamp) * 1e-3;
+    }
+#else
+    static_cast<void>(stop_stamp);
+    static_cast<void>(stop_ns);
+#endif
+    return trace_detail::writeTrace(reg, us_per_stamp);
+}
+
+bool active() { return g_active.load(std::memory_order_relaxed); }
+
+bool enabled() {
+#if defined(HFT_TRACE_ZONES)
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t writtenEvents() { return registry().written; }
+
+size_t overwrittenEvents() { return registry().overwritten; }
+
+}  // namespace trace
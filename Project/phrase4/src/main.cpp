@@ -1,9 +1,10 @@
 #include <iostream>
 #include <vector>
-#include <numeric>
 #include <algorithm>
-#include <cmath>
 #include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include "../include/Order.hpp"
 #include "../include/OrderBook.hpp"
 #include "../include/MatchingEngine.hpp"
@@ -11,6 +12,12 @@
 #include "../include/TradeLogger.hpp"
 #include "../include/MarketData.hpp"
 #include "../include/Timer.hpp"
+#include "../include/LatencyHistogram.hpp"
+#include "../include/SessionFile.hpp"
+#include "../include/Snapshot.hpp"
+#include "../include/StageProbe.hpp"
+#include "../include/TraceZone.hpp"
+#include "../include/AllocationCounter.hpp"
 
 using PriceType = double;
 using OrderIdType = int;
@@ -20,62 +27,163 @@ using MatchingEngineType = MatchingEngine<PriceType, OrderIdType>;
 using OrderManagerType = OrderManager<PriceType, OrderIdType>;
 using TradeLoggerType = TradeLogger<PriceType, OrderIdType>;
 using TradeType = Trade<PriceType, OrderIdType>;
+using OrderPoolType = OrderPool<PriceType, OrderIdType>;
 
-// Analyze latency statistics
-void analyzeLatencies(const std::vector<long long>& latencies) {
+// Analyze latency statistics and export the percentile distribution
+void analyzeLatencies(const LatencyHistogram& latencies, const std::string& export_path) {
     if (latencies.empty()) {
         std::cout << "No latency data to analyze.\n";
         return;
     }
 
-    // Sort for percentile calculations
-    auto sorted_latencies = latencies;
-    std::sort(sorted_latencies.begin(), sorted_latencies.end());
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "Tick-to-Trade Latency Analysis (nanoseconds)\n";
+    std::cout << std::string(60, '=') << "\n";
+    std::cout << "Sample Size:     " << latencies.count() << "\n";
+    std::cout << "Min:             " << latencies.min() << " ns\n";
+    std::cout << "Max:             " << latencies.max() << " ns\n";
+    std::cout << "Mean:            " << std::fixed << std::setprecision(2) << latencies.mean() << " ns\n";
+    std::cout << "Std Dev:         " << latencies.stddev() << " ns\n";
+    std::cout << "Median (P50):    " << latencies.percentile(50.0) << " ns\n";
+    std::cout << "P90:             " << latencies.percentile(90.0) << " ns\n";
+    std::cout << "P99:             " << latencies.percentile(99.0) << " ns\n";
+    std::cout << "P99.9:           " << latencies.percentile(99.9) << " ns\n";
+    std::cout << "P99.99:          " << latencies.percentile(99.99) << " ns\n";
+    if (latencies.exportDistribution(export_path)) {
+        std::cout << "Distribution:    " << export_path << "\n";
+    }
+    std::cout << std::string(60, '=') << "\n\n";
+}
 
-    auto min = sorted_latencies.front();
-    auto max = sorted_latencies.back();
-    double mean = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+// Trade log settings selected on the command line
+struct LogSettings {
+    LogFormat format = LogFormat::Text;
+    bool async = false;
+};
+
+// Trade logger for a scenario: trades_<scenario>.log (CSV) or .bin (journal)
+TradeLoggerType makeTradeLogger(const std::string& scenario, const LogSettings& settings) {
+    TradeLoggerType logger("trades_" + scenario + (settings.format == LogFormat::Binary ? ".bin" : ".log"),
+                           true, 1000, settings.format);
+    if (settings.async) logger.enableAsync();
+    return logger;
+}
 
-    // Calculate standard deviation
-    double variance = 0.0;
-    for (auto l : latencies) {
-        variance += (l - mean) * (l - mean);
+// Session recording for a scenario: <prefix>_<scenario>.session, or none
+std::unique_ptr<SessionRecorder> makeRecorder(const std::string& prefix, const std::string& scenario) {
+    if (prefix.empty()) return nullptr;
+    auto recorder = std::make_unique<SessionRecorder>(prefix + "_" + scenario + ".session");
+    if (!recorder->isOpen()) {
+        std::cerr << "Could not open " << recorder->path() << " for recording\n";
+        return nullptr;
     }
-    double stddev = std::sqrt(variance / latencies.size());
+    return recorder;
+}
 
-    // Calculate percentiles
-    auto p50 = sorted_latencies[static_cast<size_t>(latencies.size() * 0.50)];
-    auto p95 = sorted_latencies[static_cast<size_t>(latencies.size() * 0.95)];
-    auto p99 = sorted_latencies[static_cast<size_t>(latencies.size() * 0.99)];
+// Fills of one incoming order, reused across iterations
+struct FillBatch {
+    std::vector<TradeType> trades;
+    FillBatch() { trades.reserve(256); }
+};
+
+// Match an order, then log its fills as one batch. Buffering the fills
+// keeps logging out of the "match" stage so each is probed separately.
+template <typename OrderPtr>
+void matchAndLog(MatchingEngineType& engine, OrderPtr order, FillBatch& fills, TradeLoggerType& logger) {
+    fills.trades.clear();
+    {
+        HFT_PROBE_SCOPE("match");
+        engine.matchOrder(std::move(order), [&fills](const TradeType& trade) { fills.trades.push_back(trade); });
+    }
+    if (!fills.trades.empty()) {
+        HFT_PROBE_SCOPE("log");
+        logger.logTrades(fills.trades);
+    }
+}
 
-    std::cout << "\n" << std::string(60, '=') << "\n";
-    std::cout << "Tick-to-Trade Latency Analysis (nanoseconds)\n";
-    std::cout << std::string(60, '=') << "\n";
-    std::cout << "Sample Size:     " << latencies.size() << "\n";
-    std::cout << "Min:             " << min << " ns\n";
-    std::cout << "Max:             " << max << " ns\n";
-    std::cout << "Mean:            " << std::fixed << std::setprecision(2) << mean << " ns\n";
-    std::cout << "Std Dev:         " << stddev << " ns\n";
-    std::cout << "Median (P50):    " << p50 << " ns\n";
-    std::cout << "P95:             " << p95 << " ns\n";
-    std::cout << "P99:             " << p99 << " ns\n";
-    std::cout << std::string(60, '=') << "\n\n";
+void reportRecording(const SessionRecorder* recorder) {
+    if (!recorder) return;
+    std::cout << "Recorded " << recorder->eventCount() << " events to " << recorder->path() << "\n\n";
+}
+
+// Warm-restart snapshots: <prefix>_<scenario>.snap
+struct SnapshotSettings {
+    std::string save_prefix;     // capture each scenario's final state
+    std::string restore_prefix;  // start each scenario from a saved state
+    SnapshotWriter writer;       // one background write at a time
+};
+
+// Report the background write started by the previous saveSnapshot()
+void reportSnapshotWrite(SnapshotWriter& writer) {
+    if (!writer.started()) return;
+    if (writer.wait()) {
+        std::cout << "Snapshot " << writer.path() << ": " << writer.recordCount() << " records written in "
+                  << std::fixed << std::setprecision(2) << writer.writeNs() / 1e6 << " ms (background)\n";
+    } else {
+        std::cerr << "Could not write snapshot " << writer.path() << "\n";
+    }
+}
+
+// Load the scenario's snapshot into its (still empty) manager and book
+void restoreSnapshot(const SnapshotSettings& settings, const std::string& scenario,
+                     OrderManagerType& order_manager, OrderBookType& order_book) {
+    if (settings.restore_prefix.empty()) return;
+    const std::string path = settings.restore_prefix + "_" + scenario + ".snap";
+
+    uint64_t start = timer_detail::steadyNs();
+    SnapshotReader snapshot(path);
+    if (!snapshot.isOpen() || !restoreOrderManager(snapshot, order_manager) ||
+        !restoreBook(snapshot, order_manager, order_book)) {
+        std::cerr << "Could not restore snapshot " << path << "\n";
+        return;
+    }
+    uint64_t restore_ns = timer_detail::steadyNs() - start;
+
+    std::cout << "Restored " << path << ": " << order_manager.getTotalOrders() << " orders, "
+              << order_book.getTotalOrderCount() << " resting, in " << std::fixed
+              << std::setprecision(2) << restore_ns / 1e6 << " ms\n\n";
+}
+
+// Capture manager + book at a quiescent point (no order in flight) and
+// write the file in the background while the run carries on
+void saveSnapshot(SnapshotSettings& settings, const std::string& scenario,
+                  const OrderManagerType& order_manager, const OrderBookType& order_book) {
+    if (settings.save_prefix.empty()) return;
+    reportSnapshotWrite(settings.writer);
+
+    std::vector<SnapshotRecord> records = settings.writer.takeBuffer();
+    uint64_t start = timer_detail::steadyNs();
+    records.reserve(order_manager.getTotalOrders() + order_book.getTotalOrderCount());
+    captureOrderManager(order_manager, records);
+    captureBook(order_book, records);
+    uint64_t capture_ns = timer_detail::steadyNs() - start;
+
+    size_t count = records.size();
+    settings.writer.writeAsync(settings.save_prefix + "_" + scenario + ".snap", std::move(records));
+    std::cout << "Snapshot captured: " << count << " records in " << std::fixed
+              << std::setprecision(3) << capture_ns / 1e6 << " ms (matching paused)\n\n";
 }
 
 // Run a basic HFT simulation
-void runBasicSimulation(int num_ticks) {
+void runBasicSimulation(int num_ticks, const LogSettings& log_settings, SessionRecorder* recorder,
+                        SnapshotSettings& snapshots) {
     std::cout << "\n*** Running Basic HFT Simulation ***\n";
     std::cout << "Number of ticks: " << num_ticks << "\n\n";
 
-    // Initialize components
+    // Initialize components (pool first: it must outlive the resting orders)
+    OrderPoolType order_pool(1024);
+    order_pool.reserve(num_ticks);
     OrderBookType order_book("AAPL");
+    const SymbolId symbol = internSymbol("AAPL");
     MatchingEngineType matching_engine(order_book);
-    OrderManagerType order_manager;
-    TradeLoggerType trade_logger("trades_basic.log");
+    OrderManagerType order_manager(order_pool);
+    TradeLoggerType trade_logger = makeTradeLogger("basic", log_settings);
     MarketDataFeed market_feed(150.0);
+    restoreSnapshot(snapshots, "basic", order_manager, order_book);
 
-    std::vector<long long> latencies;
-    latencies.reserve(num_ticks);
+    LatencyHistogram latencies;
+    FillBatch fills;
+    stage_probe::reset();
 
     Timer timer;
 
@@ -84,169 +192,464 @@ void runBasicSimulation(int num_ticks) {
         timer.start();
 
         // Generate market data tick
-        auto market_data = market_feed.generateTick("AAPL");
+        HFT_PROBE_BEGIN(tick_probe, "tick");
+        auto market_data = market_feed.generateTick(symbol);
+        HFT_PROBE_END(tick_probe);
 
         // Create orders based on market data
         bool is_buy = (i % 2 == 0);
         double price = is_buy ? market_data.bid_price : market_data.ask_price;
         int quantity = 100 + (i % 5) * 20;
 
+        if (recorder) {
+            HFT_PROBE_SCOPE("record");
+            recorder->recordTick(market_data);
+            recorder->recordOrder(symbol, price, quantity, is_buy);
+        }
+
         // Create and submit order
-        auto order = order_manager.createOrder("AAPL", price, quantity, is_buy);
-        
-        // Match order
-        auto trades = matching_engine.matchOrder(std::move(order));
+        HFT_PROBE_BEGIN(create_probe, "create");
+        auto order = order_manager.createOrder(symbol, price, quantity, is_buy);
+        HFT_PROBE_END(create_probe);
 
-        // Log trades
-        if (!trades.empty()) {
-            trade_logger.logTrades(trades);
-        }
+        // Match order, then log its fills as one batch
+        matchAndLog(matching_engine, std::move(order), fills, trade_logger);
 
         // Record latency
-        long long latency = timer.stop();
-        latencies.push_back(latency);
+        latencies.record(timer.stop());
+        HFT_PROBE_DRAIN();
     }
+    saveSnapshot(snapshots, "basic", order_manager, order_book);
 
     // Flush remaining trades
     trade_logger.flush();
 
     // Analyze results
-    analyzeLatencies(latencies);
+    analyzeLatencies(latencies, "latency_basic.hgrm");
+    stage_probe::printReport(std::cout, "basic");
 
     // Print trade summary
     std::cout << trade_logger.generateSummary(matching_engine.getTrades());
     std::cout << "Total trades executed: " << matching_engine.getTradeCount() << "\n";
     std::cout << "Orders in book - Buy: " << order_book.getBuyOrderCount() 
               << ", Sell: " << order_book.getSellOrderCount() << "\n\n";
+    reportRecording(recorder);
 }
 
 // Run an aggressive matching simulation
-void runAggressiveSimulation(int num_orders) {
+void runAggressiveSimulation(int num_orders, const LogSettings& log_settings, SessionRecorder* recorder,
+                             SnapshotSettings& snapshots) {
     std::cout << "\n*** Running Aggressive Matching Simulation ***\n";
     std::cout << "Number of orders: " << num_orders << "\n\n";
 
+    OrderPoolType order_pool(1024);
+    order_pool.reserve(num_orders + num_orders / 2);
     OrderBookType order_book("MSFT");
+    const SymbolId symbol = internSymbol("MSFT");
     MatchingEngineType matching_engine(order_book);
-    OrderManagerType order_manager;
-    TradeLoggerType trade_logger("trades_aggressive.log");
+    OrderManagerType order_manager(order_pool);
+    TradeLoggerType trade_logger = makeTradeLogger("aggressive", log_settings);
     MarketDataFeed market_feed(300.0);
+    restoreSnapshot(snapshots, "aggressive", order_manager, order_book);
 
-    std::vector<long long> latencies;
-    latencies.reserve(num_orders);
+    LatencyHistogram latencies;
+    FillBatch fills;
 
     Timer timer;
 
     // First, populate the order book with resting orders
     std::cout << "Populating order book...\n";
     for (int i = 0; i < num_orders / 2; ++i) {
-        auto market_data = market_feed.generateTick("MSFT");
+        auto market_data = market_feed.generateTick(symbol);
+        if (recorder) {
+            recorder->recordTick(market_data);
+            recorder->recordOrder(symbol, market_data.bid_price, 100, true, SessionEventType::RestingOrder);
+            recorder->recordOrder(symbol, market_data.ask_price, 100, false, SessionEventType::RestingOrder);
+        }
         
         // Add buy order
-        auto buy_order = order_manager.createOrder("MSFT", market_data.bid_price, 100, true);
+        auto buy_order = order_manager.createOrder(symbol, market_data.bid_price, 100, true);
         order_book.addBuyOrder(std::move(buy_order));
         
         // Add sell order
-        auto sell_order = order_manager.createOrder("MSFT", market_data.ask_price, 100, false);
+        auto sell_order = order_manager.createOrder(symbol, market_data.ask_price, 100, false);
         order_book.addSellOrder(std::move(sell_order));
     }
 
     std::cout << "Order book populated. Starting matching...\n";
+    stage_probe::reset();
 
     // Now send aggressive orders that cross the spread
     for (int i = 0; i < num_orders / 2; ++i) {
         timer.start();
 
-        auto market_data = market_feed.generateTick("MSFT");
+        HFT_PROBE_BEGIN(tick_probe, "tick");
+        auto market_data = market_feed.generateTick(symbol);
+        HFT_PROBE_END(tick_probe);
         
         // Create aggressive order that will match
         bool is_buy = (i % 2 == 0);
         // Buy at ask price or sell at bid price (aggressive)
         double price = is_buy ? market_data.ask_price + 1.0 : market_data.bid_price - 1.0;
+        if (recorder) {
+            HFT_PROBE_SCOPE("record");
+            recorder->recordTick(market_data);
+            recorder->recordOrder(symbol, price, 100, is_buy);
+        }
         
-        auto order = order_manager.createOrder("MSFT", price, 100, is_buy);
-        auto trades = matching_engine.matchOrder(std::move(order));
+        HFT_PROBE_BEGIN(create_probe, "create");
+        auto order = order_manager.createOrder(symbol, price, 100, is_buy);
+        HFT_PROBE_END(create_probe);
 
-        if (!trades.empty()) {
-            trade_logger.logTrades(trades);
-        }
+        matchAndLog(matching_engine, std::move(order), fills, trade_logger);
 
-        long long latency = timer.stop();
-        latencies.push_back(latency);
+        latencies.record(timer.stop());
+        HFT_PROBE_DRAIN();
     }
+    saveSnapshot(snapshots, "aggressive", order_manager, order_book);
 
     trade_logger.flush();
 
     // Analyze results
-    analyzeLatencies(latencies);
+    analyzeLatencies(latencies, "latency_aggressive.hgrm");
+    stage_probe::printReport(std::cout, "aggressive");
     
     std::cout << trade_logger.generateSummary(matching_engine.getTrades());
     std::cout << "Total trades executed: " << matching_engine.getTradeCount() << "\n";
     std::cout << "Orders remaining in book - Buy: " << order_book.getBuyOrderCount() 
               << ", Sell: " << order_book.getSellOrderCount() << "\n\n";
+    reportRecording(recorder);
 }
 
-int main() {
-    std::cout << "\n";
-    std::cout << "====================================================================\n";
-    std::cout << "    High-Frequency Trading System - Phase 4 Project\n";
-    std::cout << "                    IEOR E4741\n";
-    std::cout << "====================================================================\n";
-
-    // Run different simulation scenarios
-    
-    // Scenario 1: Basic simulation with 10K ticks
-    runBasicSimulation(10000);
-
-    // Scenario 2: Aggressive matching with 5K orders
-    runAggressiveSimulation(5000);
-
-    // Scenario 3: Stress test with 100K ticks
-    std::cout << "\n*** Running Stress Test (100K ticks) ***\n";
+// Run the stress test
+void runStressTest(int num_ticks, const LogSettings& log_settings, SessionRecorder* recorder,
+                   SnapshotSettings& snapshots) {
+    std::cout << "\n*** Running Stress Test (" << num_ticks / 1000 << "K ticks) ***\n";
     std::cout << "This may take a moment...\n\n";
     
+    OrderPoolType stress_pool(1024);
+    stress_pool.reserve(num_ticks);
     OrderBookType stress_book("GOOGL");
+    const SymbolId symbol = internSymbol("GOOGL");
     MatchingEngineType stress_engine(stress_book);
-    OrderManagerType stress_manager;
-    TradeLoggerType stress_logger("trades_stress.log");
+    OrderManagerType stress_manager(stress_pool);
+    TradeLoggerType stress_logger = makeTradeLogger("stress", log_settings);
     MarketDataFeed stress_feed(2800.0);
+    restoreSnapshot(snapshots, "stress", stress_manager, stress_book);
 
-    std::vector<long long> stress_latencies;
-    stress_latencies.reserve(100000);
+    LatencyHistogram stress_latencies;
+    FillBatch fills;
+    stage_probe::reset();
     
     Timer stress_timer;
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    for (int i = 0; i < 100000; ++i) {
+    for (int i = 0; i < num_ticks; ++i) {
         stress_timer.start();
         
-        auto market_data = stress_feed.generateTick("GOOGL");
+        HFT_PROBE_BEGIN(tick_probe, "tick");
+        auto market_data = stress_feed.generateTick(symbol);
+        HFT_PROBE_END(tick_probe);
         bool is_buy = (i % 3 != 0);  // 2/3 buy, 1/3 sell
         double price = is_buy ? market_data.bid_price : market_data.ask_price;
-        
-        auto order = stress_manager.createOrder("GOOGL", price, 50 + (i % 10) * 10, is_buy);
-        auto trades = stress_engine.matchOrder(std::move(order));
-        
-        if (!trades.empty()) {
-            stress_logger.logTrades(trades);
+        int quantity = 50 + (i % 10) * 10;
+        if (recorder) {
+            HFT_PROBE_SCOPE("record");
+            recorder->recordTick(market_data);
+            recorder->recordOrder(symbol, price, quantity, is_buy);
         }
         
-        stress_latencies.push_back(stress_timer.stop());
+        HFT_PROBE_BEGIN(create_probe, "create");
+        auto order = stress_manager.createOrder(symbol, price, quantity, is_buy);
+        HFT_PROBE_END(create_probe);
+
+        matchAndLog(stress_engine, std::move(order), fills, stress_logger);
+        
+        stress_latencies.record(stress_timer.stop());
+        HFT_PROBE_DRAIN();
     }
+    saveSnapshot(snapshots, "stress", stress_manager, stress_book);
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
 
     stress_logger.flush();
 
-    analyzeLatencies(stress_latencies);
+    analyzeLatencies(stress_latencies, "latency_stress.hgrm");
+    stage_probe::printReport(std::cout, "stress");
     
     std::cout << "Total execution time: " << total_time << " ms\n";
-    std::cout << "Throughput: " << (100000.0 / total_time * 1000.0) << " ticks/second\n";
+    std::cout << "Throughput: " << (static_cast<double>(num_ticks) / total_time * 1000.0) << " ticks/second\n";
     std::cout << stress_logger.generateSummary(stress_engine.getTrades());
     std::cout << "Total trades: " << stress_engine.getTradeCount() << "\n\n";
+    reportRecording(recorder);
+}
+
+// Drive OrderManager/MatchingEngine straight from a recorded session.
+// Nothing is generated, so only order creation + matching is timed. With
+// paced set, each event waits for its recorded offset from the start;
+// otherwise events are replayed back to back at full speed.
+bool replaySession(const std::string& path, const std::string& scenario, bool paced,
+                   const LogSettings& log_settings) {
+    SessionReader session(path);
+    if (!session.isOpen()) {
+        std::cerr << "Could not open session " << path << "\n";
+        return false;
+    }
+
+    std::cout << "\n*** Replaying " << path << (paced ? " (recorded pacing)" : " (full speed)") << " ***\n";
+
+    // Recorded SymbolIds -> ids interned in this process
+    const std::vector<SymbolId> symbols = session.internSymbols();
+    auto localSymbol = [&symbols](uint32_t id) { return id < symbols.size() ? symbols[id] : SymbolId{0}; };
+
+    // One book per session: the symbol of the first order
+    size_t order_events = 0;
+    uint32_t book_symbol = 0;
+    for (const SessionEvent& event : session) {
+        if (event.type == static_cast<uint8_t>(SessionEventType::Tick)) continue;
+        if (order_events++ == 0) book_symbol = event.symbol;
+    }
+
+    OrderPoolType order_pool(1024);
+    order_pool.reserve(order_events);
+    OrderBookType order_book(session.symbol(book_symbol));
+    const SymbolId symbol = localSymbol(book_symbol);
+    MatchingEngineType matching_engine(order_book);
+    OrderManagerType order_manager(order_pool);
+    TradeLoggerType trade_logger = makeTradeLogger("replay_" + scenario, log_settings);
+
+    LatencyHistogram latencies;
+    FillBatch fills;
+    Timer timer;
+    size_t ticks = 0;
+    size_t skipped = 0;
+    stage_probe::reset();
+
+    const uint64_t replay_start = timer_detail::steadyNs();
+    for (const SessionEvent& event : session) {
+        if (paced) {
+            while (timer_detail::steadyNs() - replay_start < static_cast<uint64_t>(event.timestamp_ns)) {
+            }
+        }
+
+        auto type = static_cast<SessionEventType>(event.type);
+        if (type == SessionEventType::Tick) {
+            ++ticks;
+            continue;
+        }
+        if (event.symbol != book_symbol) {
+            ++skipped;
+            continue;
+        }
+
+        if (type == SessionEventType::RestingOrder) {
+            auto order = order_manager.createOrder(symbol, event.price, event.quantity, event.is_buy != 0);
+            if (!order) {
+                ++skipped;
+                continue;
+            }
+            if (event.is_buy) {
+                order_book.addBuyOrder(std::move(order));
+            } else {
+                order_book.addSellOrder(std::move(order));
+            }
+            continue;
+        }
+
+        timer.start();
+        HFT_PROBE_BEGIN(create_probe, "create");
+        auto order = order_manager.createOrder(symbol, event.price, event.quantity, event.is_buy != 0);
+        HFT_PROBE_END(create_probe);
+        if (!order) {
+            ++skipped;
+            continue;
+        }
+        matchAndLog(matching_engine, std::move(order), fills, trade_logger);
+        latencies.record(timer.stop());
+        HFT_PROBE_DRAIN();
+    }
+    uint64_t total_ns = timer_detail::steadyNs() - replay_start;
+
+    trade_logger.flush();
+
+    std::cout << "Events: " << session.size() << " (" << ticks << " ticks, " << order_events
+              << " orders, " << skipped << " skipped)\n";
+    analyzeLatencies(latencies, "latency_replay_" + scenario + ".hgrm");
+    stage_probe::printReport(std::cout, "replay");
+
+    std::cout << "Replay time: " << std::fixed << std::setprecision(2) << total_ns / 1e6 << " ms\n";
+    std::cout << trade_logger.generateSummary(matching_engine.getTrades());
+    std::cout << "Total trades executed: " << matching_engine.getTradeCount() << "\n";
+    std::cout << "Orders in book - Buy: " << order_book.getBuyOrderCount()
+              << ", Sell: " << order_book.getSellOrderCount() << "\n\n";
+    return true;
+}
+
+// Count allocations made by the tick loop with heap-allocated vs pooled orders
+void runAllocationReport(int num_ticks) {
+    std::cout << "\n*** Allocation Report (" << num_ticks << " ticks) ***\n\n";
+
+    auto runTicks = [num_ticks](OrderManagerType& order_manager, OrderBookType& order_book,
+                                size_t& create_allocs, bool use_sink) {
+        MatchingEngineType matching_engine(order_book, !use_sink);
+        FixedTradeBuffer<TradeType> fills(256);
+        MarketDataFeed market_feed(150.0);
+        const SymbolId symbol = order_book.getSymbolId();
+        create_allocs = 0;
+
+        size_t before = allocationCount();
+        for (int i = 0; i < num_ticks; ++i) {
+            auto market_data = market_feed.generateTick(symbol);
+            bool is_buy = (i % 2 == 0);
+            double price = is_buy ? market_data.bid_price : market_data.ask_price;
+
+            size_t create_before = allocationCount();
+            auto order = order_manager.createOrder(symbol, price, 100 + (i % 5) * 20, is_buy);
+            create_allocs += allocationCount() - create_before;
+
+            if (use_sink) {
+                fills.clear();
+                matching_engine.matchOrder(std::move(order), fills);
+            } else {
+                matching_engine.matchOrder(std::move(order));
+            }
+        }
+        return allocationCount() - before;
+    };
+
+    auto printRow = [num_ticks](const char* label, size_t total, size_t create) {
+        std::cout << std::left << std::setw(22) << label << std::right
+                  << std::setw(12) << total << std::setw(14) << create
+                  << std::setw(16) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(total) / num_ticks) << "\n";
+    };
+
+    size_t heap_create = 0;
+    size_t heap_total = 0;
+    {
+        OrderBookType order_book("AAPL");
+        OrderManagerType order_manager;
+        heap_total = runTicks(order_manager, order_book, heap_create, false);
+    }
+
+    size_t pool_create = 0;
+    size_t pool_total = 0;
+    {
+        OrderPoolType order_pool(1024);
+        order_pool.reserve(num_ticks);
+        OrderBookType order_book("AAPL");
+        OrderManagerType order_manager(order_pool);
+        pool_total = runTicks(order_manager, order_book, pool_create, false);
+    }
+
+    size_t sink_create = 0;
+    size_t sink_total = 0;
+    {
+        OrderPoolType order_pool(1024);
+        order_pool.reserve(num_ticks);
+        OrderBookType order_book("AAPL");
+        OrderManagerType order_manager(order_pool);
+        sink_total = runTicks(order_manager, order_book, sink_create, true);
+    }
+
+    std::cout << std::left << std::setw(22) << "Order allocation" << std::right
+              << std::setw(12) << "mallocs" << std::setw(14) << "createOrder"
+              << std::setw(16) << "mallocs/tick" << "\n";
+    std::cout << std::string(64, '-') << "\n";
+    printRow("Heap (before)", heap_total, heap_create);
+    printRow("Pooled (after)", pool_total, pool_create);
+    printRow("Pooled + trade sink", sink_total, sink_create);
+    std::cout << "\nOrder objects saved from the system allocator: "
+              << (heap_create - pool_create) << "\n\n";
+}
+
+// Write the timeline recorded since --trace
+void finishTrace(const std::string& path) {
+    if (path.empty()) return;
+    if (!trace::stop()) {
+        std::cerr << "Could not write trace " << path << "\n";
+        return;
+    }
+    std::cout << "Trace " << path << ": " << trace::writtenEvents() << " zones";
+    if (trace::overwrittenEvents() > 0) {
+        std::cout << " (" << trace::overwrittenEvents() << " older zones overwritten)";
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--alloc-report") == 0) {
+        runAllocationReport(argc > 2 ? std::atoi(argv[2]) : 100000);
+        return 0;
+    }
+
+    // --binary-log:       write memory-mapped journals instead of CSV
+    // --async-log:        format and write trades on a background writer thread
+    // --record <prefix>:  capture each scenario to <prefix>_<scenario>.session
+    // --replay <prefix>:  replay recorded sessions instead of generating data
+    // --paced:            replay at the recorded pacing instead of full speed
+    // --snapshot <prefix>: save each scenario's book + orders to <prefix>_<scenario>.snap
+    // --restore <prefix>:  warm start each scenario from those snapshots
+    // --trace <file>:      write a Chrome trace-event timeline of the hot path
+    LogSettings log_settings;
+    SnapshotSettings snapshots;
+    std::string record_prefix;
+    std::string replay_prefix;
+    std::string trace_path;
+    bool paced = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--binary-log") == 0) log_settings.format = LogFormat::Binary;
+        if (std::strcmp(argv[i], "--async-log") == 0) log_settings.async = true;
+        if (std::strcmp(argv[i], "--paced") == 0) paced = true;
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) record_prefix = argv[++i];
+        if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replay_prefix = argv[++i];
+        if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) snapshots.save_prefix = argv[++i];
+        if (std::strcmp(argv[i], "--restore") == 0 && i + 1 < argc) snapshots.restore_prefix = argv[++i];
+        if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_path = argv[++i];
+    }
+
+    std::cout << "\n";
+    std::cout << "====================================================================\n";
+    std::cout << "    High-Frequency Trading System - Phase 4 Project\n";
+    std::cout << "                    IEOR E4741\n";
+    std::cout << "====================================================================\n";
+
+    if (!trace_path.empty()) {
+        if (!trace::enabled()) std::cout << "Trace zones compiled out (HFT_TRACE_ZONES=OFF)\n";
+        trace::start(trace_path);
+    }
+
+    const char* scenarios[] = {"basic", "aggressive", "stress"};
+
+    if (!replay_prefix.empty()) {
+        bool replayed = false;
+        for (const char* scenario : scenarios) {
+            replayed |= replaySession(replay_prefix + "_" + scenario + ".session", scenario, paced, log_settings);
+        }
+        finishTrace(trace_path);
+        return replayed ? 0 : 1;
+    }
+
+    // Run different simulation scenarios
+    
+    // Scenario 1: Basic simulation with 10K ticks
+    runBasicSimulation(10000, log_settings, makeRecorder(record_prefix, scenarios[0]).get(), snapshots);
+
+    // Scenario 2: Aggressive matching with 5K orders
+    runAggressiveSimulation(5000, log_settings, makeRecorder(record_prefix, scenarios[1]).get(), snapshots);
+
+    // Scenario 3: Stress test with 100K ticks
+    runStressTest(100000, log_settings, makeRecorder(record_prefix, scenarios[2]).get(), snapshots);
+    reportSnapshotWrite(snapshots.writer);
+    finishTrace(trace_path);
 
     std::cout << "\nAll simulations completed successfully.\n";
-    std::cout << "Check trades_*.log files for detailed trade logs.\n\n";
+    if (log_settings.format == LogFormat::Binary) {
+        std::cout << "Trade journals written to trades_*.bin (convert with journal_to_csv).\n\n";
+    } else {
+        std::cout << "Check trades_*.log files for detailed trade logs.\n\n";
+    }
 
     return 0;
 }
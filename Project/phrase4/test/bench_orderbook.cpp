@@ -0,0 +1,617 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <iomanip>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include "../include/OrderBook.hpp"
+#include "../include/MapOrderBook.hpp"
+#include "../include/MatchingEngine.hpp"
+#include "../include/OrderManager.hpp"
+#include "../include/Price.hpp"
+#include "../include/Timer.hpp"
+#include "../include/LatencyHistogram.hpp"
+
+using OrderIdType = int;
+
+// Command-line configuration (all workloads share the distributions)
+struct BenchConfig {
+    std::string workloads = "add,cancel,sweep,deep,deep-sweep,batch";
+    size_t orders = 200000;          // timed operations per workload
+    size_t deep_orders = 1000000;    // resting orders before the deep workloads
+    std::string price_dist = "exponential";  // uniform | exponential
+    int price_range = 50;            // max distance from mid, in ticks
+    std::string size_dist = "uniform";       // fixed | uniform | lognormal
+    int size_mean = 100;
+    int sweep_levels = 20;           // levels per side refilled for sweeps
+    int sweep_depth = 64;            // resting orders each deep-sweep order fills
+    std::vector<size_t> batch_sizes = {1, 8, 64, 512};  // matchOrders batch sizes
+    uint32_t seed = 42;
+    std::string json_path;           // "-" writes JSON to stdout
+};
+
+// One pre-generated operation, in ticks so every book variant replays
+// identical input. Orders get ids 1, 2, ... in submission order, which is
+// what the OrderManager assigns, so cancels can name them up front.
+struct BookOp {
+    enum Kind : uint8_t { Add, Cancel, Sweep };  // Add/Sweep submit an order
+    Kind kind;
+    bool is_buy;
+    int quantity;
+    PriceTicks price;
+    OrderIdType order_id;  // cancel target
+};
+
+struct Workload {
+    std::string name;
+    std::vector<BookOp> setup;  // untimed (book building)
+    std::vector<BookOp> ops;    // timed
+};
+
+// FixedTradeBuffer capacity that cannot overflow while `orders` submits
+// are matched between clears: each fill takes at least one unit of an
+// incoming quantity and consumes a resting order
+size_t maxFills(const Workload& workload, size_t orders) {
+    size_t largest = 1;
+    for (const auto* ops : {&workload.setup, &workload.ops}) {
+        for (const BookOp& op : *ops) {
+            if (op.kind != BookOp::Cancel) largest = std::max(largest, static_cast<size_t>(op.quantity));
+        }
+    }
+    return std::min(largest * orders, workload.setup.size() + workload.ops.size());
+}
+
+static const char* kindName(int kind) {
+    static const char* names[] = {"add", "cancel", "sweep"};
+    return names[kind];
+}
+
+// Price / size sampling from the configured distributions
+class OrderGenerator {
+public:
+    explicit OrderGenerator(const BenchConfig& cfg) : config(cfg), rng(cfg.seed) {}
+
+    // Distance from mid in ticks, 1..price_range
+    int offset() {
+        int range = std::max(config.price_range, 1);
+        if (config.price_dist == "uniform") {
+            return 1 + static_cast<int>(rng() % static_cast<uint32_t>(range));
+        }
+        // exponential: most orders near the touch, mean range / 4
+        std::exponential_distribution<double> dist(4.0 / range);
+        return std::min(range, 1 + static_cast<int>(dist(rng)));
+    }
+
+    int size() {
+        int mean = std::max(config.size_mean, 1);
+        if (config.size_dist == "fixed") return mean;
+        if (config.size_dist == "lognormal") {
+            const double sigma = 0.8;
+            std::lognormal_distribution<double> dist(std::log(mean) - sigma * sigma / 2, sigma);
+            return std::max(1, static_cast<int>(dist(rng)));
+        }
+        return 1 + static_cast<int>(rng() % static_cast<uint32_t>(2 * mean - 1));
+    }
+
+    bool coin() { return (rng() & 1) != 0; }
+    uint32_t below(uint32_t n) { return n ? static_cast<uint32_t>(rng() % n) : 0; }
+
+    // Resting (non-crossing) order around a fixed mid
+    BookOp passive(OrderIdType& next_id) {
+        bool is_buy = coin();
+        PriceTicks price = is_buy ? mid - offset() : mid + offset();
+        ++next_id;
+        return BookOp{BookOp::Add, is_buy, size(), price, 0};
+    }
+
+    static constexpr PriceTicks mid = 15000;
+
+private:
+    const BenchConfig& config;
+    std::mt19937 rng;
+};
+
+// Add-only: the book only grows
+Workload makeAddOnly(const BenchConfig& config) {
+    OrderGenerator gen(config);
+    Workload workload{"add-only", {}, {}};
+    OrderIdType next_id = 0;
+    for (size_t i = 0; i < config.orders; ++i) workload.ops.push_back(gen.passive(next_id));
+    return workload;
+}
+
+// Cancel-heavy: every add is followed by a cancel of a random live order
+// 90% of the time
+Workload makeCancelHeavy(const BenchConfig& config) {
+    OrderGenerator gen(config);
+    Workload workload{"cancel-heavy", {}, {}};
+    OrderIdType next_id = 0;
+    std::vector<OrderIdType> live;
+    while (workload.ops.size() < config.orders) {
+        workload.ops.push_back(gen.passive(next_id));
+        live.push_back(next_id);
+        if (gen.below(10) != 0) {
+            size_t victim = gen.below(static_cast<uint32_t>(live.size()));
+            workload.ops.push_back(BookOp{BookOp::Cancel, false, 0, 0, live[victim]});
+            live[victim] = live.back();
+            live.pop_back();
+        }
+    }
+    return workload;
+}
+
+// Aggressive sweeps: both sides are refilled with sweep_levels levels of
+// resting orders whenever one runs low, then marketable orders several
+// times the mean size walk through the levels
+Workload makeSweep(const BenchConfig& config) {
+    OrderGenerator gen(config);
+    Workload workload{"aggressive-sweep", {}, {}};
+    const int levels = std::max(config.sweep_levels, 1);
+    const long long refill_quantity = static_cast<long long>(levels) * 4 * config.size_mean;
+    long long resting[2] = {0, 0};  // [sell, buy] approximate resting quantity
+
+    OrderIdType next_id = 0;
+    while (workload.ops.size() < config.orders) {
+        for (int side = 0; side < 2; ++side) {
+            if (resting[side] >= refill_quantity / 2) continue;
+            bool is_buy = side == 1;
+            for (int level = 1; level <= levels; ++level) {
+                for (int k = 0; k < 4; ++k) {
+                    int quantity = gen.size();
+                    PriceTicks price = is_buy ? OrderGenerator::mid - level : OrderGenerator::mid + level;
+                    workload.ops.push_back(BookOp{BookOp::Add, is_buy, quantity, price, 0});
+                    ++next_id;
+                    resting[side] += quantity;
+                }
+            }
+        }
+
+        bool is_buy = gen.coin();
+        int quantity = gen.size() * (2 + static_cast<int>(gen.below(8)));
+        PriceTicks limit = is_buy ? OrderGenerator::mid + levels : OrderGenerator::mid - levels;
+        workload.ops.push_back(BookOp{BookOp::Sweep, is_buy, quantity, limit, 0});
+        ++next_id;
+        resting[is_buy ? 0 : 1] -= quantity;
+    }
+    return workload;
+}
+
+// Deep book: deep_orders resting orders spread over price_range * 20 levels
+// per side, then a mix of adds near the touch (50%), cancels anywhere in
+// the book (35%) and sweeps (15%)
+Workload makeDeep(const BenchConfig& config) {
+    OrderGenerator gen(config);
+    Workload workload{"deep-book", {}, {}};
+    const int depth = std::max(config.price_range, 1) * 20;
+
+    OrderIdType next_id = 0;
+    std::vector<OrderIdType> live;
+    live.reserve(config.deep_orders + config.orders);
+    for (size_t i = 0; i < config.deep_orders; ++i) {
+        bool is_buy = gen.coin();
+        PriceTicks away = 1 + gen.below(static_cast<uint32_t>(depth));
+        PriceTicks price = is_buy ? OrderGenerator::mid - away : OrderGenerator::mid + away;
+        workload.setup.push_back(BookOp{BookOp::Add, is_buy, gen.size(), price, 0});
+        live.push_back(++next_id);
+    }
+
+    while (workload.ops.size() < config.orders) {
+        uint32_t roll = gen.below(100);
+        if (roll < 50) {
+            workload.ops.push_back(gen.passive(next_id));
+            live.push_back(next_id);
+        } else if (roll < 85 && !live.empty()) {
+            size_t victim = gen.below(static_cast<uint32_t>(live.size()));
+            workload.ops.push_back(BookOp{BookOp::Cancel, false, 0, 0, live[victim]});
+            live[victim] = live.back();
+            live.pop_back();
+        } else {
+            bool is_buy = gen.coin();
+            PriceTicks limit = is_buy ? OrderGenerator::mid + gen.offset() : OrderGenerator::mid - gen.offset();
+            workload.ops.push_back(BookOp{BookOp::Sweep, is_buy, gen.size() * 4, limit, 0});
+            ++next_id;
+        }
+    }
+    return workload;
+}
+
+// Deep sweep: deep_orders resting orders of exactly size_mean over
+// price_range levels per side (thousands of orders per level, arriving
+// interleaved across levels), then marketable orders alternating sides
+// that each fill exactly sweep_depth of them. Measures how fast matching
+// walks a long queue of resting orders; stops before a side runs dry.
+Workload makeDeepSweep(const BenchConfig& config) {
+    OrderGenerator gen(config);
+    Workload workload{"deep-sweep", {}, {}};
+    const int depth = std::max(config.price_range, 1);
+    const int size = std::max(config.size_mean, 1);
+    const size_t per_sweep = static_cast<size_t>(std::max(config.sweep_depth, 1));
+
+    size_t resting[2] = {0, 0};  // [sell, buy]
+    for (size_t i = 0; i < config.deep_orders; ++i) {
+        bool is_buy = gen.coin();
+        PriceTicks away = 1 + gen.below(static_cast<uint32_t>(depth));
+        PriceTicks price = is_buy ? OrderGenerator::mid - away : OrderGenerator::mid + away;
+        workload.setup.push_back(BookOp{BookOp::Add, is_buy, size, price, 0});
+        ++resting[is_buy ? 1 : 0];
+    }
+
+    const int quantity = static_cast<int>(per_sweep) * size;
+    for (bool is_buy = true; workload.ops.size() < config.orders; is_buy = !is_buy) {
+        size_t& side = resting[is_buy ? 0 : 1];
+        if (side < per_sweep) break;
+        side -= per_sweep;
+        PriceTicks limit = is_buy ? OrderGenerator::mid + depth : OrderGenerator::mid - depth;
+        workload.ops.push_back(BookOp{BookOp::Sweep, is_buy, quantity, limit, 0});
+    }
+    return workload;
+}
+
+// Burst flow for the batch API: submits only, 80% resting near the touch
+// and 20% marketable orders that sweep a few levels
+Workload makeBatchFlow(const BenchConfig& config) {
+    OrderGenerator gen(config);
+    Workload workload{"batch", {}, {}};
+    OrderIdType next_id = 0;
+    while (workload.ops.size() < config.orders) {
+        if (gen.below(100) < 80) {
+            workload.ops.push_back(gen.passive(next_id));
+            continue;
+        }
+        bool is_buy = gen.coin();
+        PriceTicks limit = is_buy ? OrderGenerator::mid + gen.offset() : OrderGenerator::mid - gen.offset();
+        workload.ops.push_back(BookOp{BookOp::Sweep, is_buy, gen.size() * 4, limit, 0});
+        ++next_id;
+    }
+    return workload;
+}
+
+// One row of the report: a (workload, book, operation) latency summary
+struct BenchResult {
+    std::string workload;
+    std::string book;
+    std::string operation;
+    uint64_t count;
+    double throughput;  // operations of this kind per second of workload time
+    double fill_rate;   // fills produced by those operations, per second
+    double mean;
+    int64_t min, p50, p90, p99, p999, p9999, max;
+    size_t resting_after;
+};
+
+// Depth tracking is only available on OrderBook
+template <typename BookType>
+auto enableDepthIfSupported(BookType& book, size_t levels, int) -> decltype(book.enableDepth(levels), void()) {
+    book.enableDepth(levels);
+}
+
+template <typename BookType>
+void enableDepthIfSupported(BookType&, size_t, long) {}
+
+// Replay one workload against one book variant. Orders are created before
+// the timer starts, so only matchOrder / cancelOrder is measured.
+template <typename BookType, typename BookPriceType>
+void runWorkload(const std::string& book_name, size_t depth_levels, const Workload& workload,
+                 std::vector<BenchResult>& results) {
+    using EngineType = MatchingEngine<BookPriceType, OrderIdType, BookType>;
+    using ManagerType = OrderManager<BookPriceType, OrderIdType>;
+    using TradeType = Trade<BookPriceType, OrderIdType>;
+
+    size_t submits = workload.setup.size();
+    for (const auto& op : workload.ops) submits += (op.kind != BookOp::Cancel);
+
+    OrderPool<BookPriceType, OrderIdType> order_pool(1024);
+    order_pool.reserve(submits);
+    BookType order_book("BENCH");
+    const SymbolId symbol = internSymbol("BENCH");
+    if (depth_levels) enableDepthIfSupported(order_book, depth_levels, 0);
+    EngineType matching_engine(order_book, false);
+    ManagerType order_manager(order_pool);
+    order_manager.reserve(submits);
+    FixedTradeBuffer<TradeType> fills(maxFills(workload, 1));
+    TickSize tick_size(0.01);
+
+    auto bookPrice = [&tick_size](PriceTicks ticks) -> BookPriceType {
+        if (std::is_integral<BookPriceType>::value) return static_cast<BookPriceType>(ticks);
+        return static_cast<BookPriceType>(tick_size.toPrice(ticks));
+    };
+
+    for (const auto& op : workload.setup) {
+        fills.clear();
+        matching_engine.matchOrder(order_manager.createOrder(symbol, bookPrice(op.price), op.quantity, op.is_buy),
+                                   fills);
+    }
+
+    LatencyHistogram latencies[3];
+    uint64_t fill_counts[3] = {0, 0, 0};
+    Timer timer;
+    uint64_t begin_ns = timer_detail::steadyNs();
+    for (const auto& op : workload.ops) {
+        if (op.kind == BookOp::Cancel) {
+            timer.start();
+            matching_engine.cancelOrder(op.order_id);
+            latencies[op.kind].record(timer.stop());
+            continue;
+        }
+        auto order = order_manager.createOrder(symbol, bookPrice(op.price), op.quantity, op.is_buy);
+        fills.clear();
+        timer.start();
+        size_t filled = matching_engine.matchOrder(std::move(order), fills);
+        latencies[op.kind].record(timer.stop());
+        fill_counts[op.kind] += filled;
+    }
+    double seconds = static_cast<double>(timer_detail::steadyNs() - begin_ns) / 1e9;
+
+    for (int kind = 0; kind < 3; ++kind) {
+        const LatencyHistogram& h = latencies[kind];
+        if (h.empty()) continue;
+        results.push_back(BenchResult{workload.name, book_name, kindName(kind), h.count(),
+                                      h.count() / seconds, fill_counts[kind] / seconds, h.mean(), h.min(),
+                                      h.percentile(50.0), h.percentile(90.0), h.percentile(99.0),
+                                      h.percentile(99.9), h.percentile(99.99), h.max(),
+                                      order_book.getTotalOrderCount()});
+    }
+}
+
+// Replay a submit-only workload in bursts of batch_size: each burst's
+// orders are created untimed, then matched either one matchOrder call at a
+// time (batch_size 0, the baseline) or with a single matchOrders call.
+// Every order in a burst is credited with the burst time / burst size.
+template <typename BookType, typename BookPriceType>
+void runBatched(const std::string& book_name, size_t depth_levels, const Workload& workload,
+                size_t batch_size, std::vector<BenchResult>& results) {
+    using EngineType = MatchingEngine<BookPriceType, OrderIdType, BookType>;
+    using ManagerType = OrderManager<BookPriceType, OrderIdType>;
+    using TradeType = Trade<BookPriceType, OrderIdType>;
+    using OrderPtr = typename EngineType::OrderPtr;
+
+    OrderPool<BookPriceType, OrderIdType> order_pool(1024);
+    order_pool.reserve(workload.ops.size());
+    BookType order_book("BENCH");
+    const SymbolId symbol = internSymbol("BENCH");
+    if (depth_levels) enableDepthIfSupported(order_book, depth_levels, 0);
+    EngineType matching_engine(order_book, false);
+    ManagerType order_manager(order_pool);
+    order_manager.reserve(workload.ops.size());
+    TickSize tick_size(0.01);
+
+    auto bookPrice = [&tick_size](PriceTicks ticks) -> BookPriceType {
+        if (std::is_integral<BookPriceType>::value) return static_cast<BookPriceType>(ticks);
+        return static_cast<BookPriceType>(tick_size.toPrice(ticks));
+    };
+
+    const size_t burst = batch_size ? batch_size : 64;
+    FixedTradeBuffer<TradeType> fills(maxFills(workload, burst));
+    std::vector<OrderPtr> batch;
+    batch.reserve(burst);
+
+    LatencyHistogram latencies;
+    Timer timer;
+    uint64_t matched_ns = 0;
+    uint64_t fill_count = 0;
+    for (size_t begin = 0; begin < workload.ops.size(); begin += burst) {
+        size_t end = std::min(begin + burst, workload.ops.size());
+        batch.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const BookOp& op = workload.ops[i];
+            batch.push_back(order_manager.createOrder(symbol, bookPrice(op.price), op.quantity, op.is_buy));
+        }
+
+        fills.clear();
+        timer.start();
+        if (batch_size) {
+            matching_engine.matchOrders(batch, fills);
+        } else {
+            for (auto& order : batch) matching_engine.matchOrder(std::move(order), fills);
+        }
+        long long elapsed = timer.stop();
+        matched_ns += static_cast<uint64_t>(elapsed);
+        fill_count += fills.size();
+
+        long long per_order = elapsed / static_cast<long long>(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) latencies.record(per_order);
+    }
+
+    const LatencyHistogram& h = latencies;
+    std::string operation = batch_size ? "batch" + std::to_string(batch_size) : "single";
+    const double seconds = static_cast<double>(matched_ns) / 1e9;
+    results.push_back(BenchResult{workload.name, book_name, operation, h.count(),
+                                  h.count() / seconds, fill_count / seconds, h.mean(), h.min(),
+                                  h.percentile(50.0), h.percentile(90.0), h.percentile(99.0),
+                                  h.percentile(99.9), h.percentile(99.99), h.max(),
+                                  order_book.getTotalOrderCount()});
+}
+
+// OrderBook<PriceT> under every level container x allocation policy
+// combination valid for PriceT (the ladder needs integral prices).
+// Names are "<levels>/<allocation><price type>".
+template <typename BookPriceType>
+void runPolicyMatrix(const std::string& price_name, const Workload& workload, std::vector<BenchResult>& results) {
+    auto name = [&price_name](const char* layout) { return std::string(layout) + "<" + price_name + ">"; };
+
+    runWorkload<OrderBook<BookPriceType, OrderIdType, TreeLevels, HeapAllocation>, BookPriceType>(
+        name("tree/heap"), 0, workload, results);
+    runWorkload<OrderBook<BookPriceType, OrderIdType, TreeLevels, PooledAllocation>, BookPriceType>(
+        name("tree/pool"), 0, workload, results);
+    runWorkload<OrderBook<BookPriceType, OrderIdType, SortedVectorLevels, HeapAllocation>, BookPriceType>(
+        name("vector/heap"), 0, workload, results);
+    runWorkload<OrderBook<BookPriceType, OrderIdType, SortedVectorLevels, PooledAllocation>, BookPriceType>(
+        name("vector/pool"), 0, workload, results);
+    if constexpr (std::is_integral<BookPriceType>::value) {
+        runWorkload<OrderBook<BookPriceType, OrderIdType, LadderLevels, HeapAllocation>, BookPriceType>(
+            name("ladder/heap"), 0, workload, results);
+        runWorkload<OrderBook<BookPriceType, OrderIdType, LadderLevels, PooledAllocation>, BookPriceType>(
+            name("ladder/pool"), 0, workload, results);
+    }
+}
+
+// Every book / engine variant on the same workload. The defaults are
+// tree/heap<double> and ladder/heap<int64_t>.
+void runAllVariants(const Workload& workload, std::vector<BenchResult>& results) {
+    runWorkload<MapOrderBook<double, OrderIdType>, double>("MapOrderBook<double>", 0, workload, results);
+    runPolicyMatrix<double>("double", workload, results);
+    runWorkload<OrderBook<double, OrderIdType>, double>("tree/heap<double>+depth10", 10, workload, results);
+    runPolicyMatrix<PriceTicks>("int64_t", workload, results);
+}
+
+// matchOrder per order vs matchOrders at each batch size, default layouts
+void runAllBatchSizes(const BenchConfig& config, const Workload& workload, std::vector<BenchResult>& results) {
+    std::vector<size_t> sizes{0};
+    sizes.insert(sizes.end(), config.batch_sizes.begin(), config.batch_sizes.end());
+    for (size_t size : sizes) {
+        runBatched<MapOrderBook<double, OrderIdType>, double>("MapOrderBook<double>", 0, workload, size, results);
+        runBatched<OrderBook<double, OrderIdType>, double>("tree/heap<double>", 0, workload, size, results);
+        runBatched<OrderBook<double, OrderIdType>, double>("tree/heap<double>+depth10", 10, workload, size, results);
+        runBatched<OrderBook<PriceTicks, OrderIdType>, PriceTicks>("ladder/heap<int64_t>", 0, workload, size, results);
+    }
+}
+
+void printTable(const std::vector<BenchResult>& results) {
+    std::cout << std::left << std::setw(18) << "Workload" << std::setw(26) << "Book" << std::setw(10) << "Op"
+              << std::right << std::setw(9) << "Count" << std::setw(12) << "ops/s" << std::setw(12) << "fills/s"
+              << std::setw(8) << "P50" << std::setw(8) << "P90" << std::setw(8) << "P99"
+              << std::setw(9) << "P99.9" << std::setw(10) << "Max" << "\n";
+    std::cout << std::string(130, '-') << "\n";
+    std::string last_workload;
+    for (const auto& r : results) {
+        if (!last_workload.empty() && r.workload != last_workload) std::cout << "\n";
+        last_workload = r.workload;
+        std::cout << std::left << std::setw(18) << r.workload << std::setw(26) << r.book << std::setw(10) << r.operation
+                  << std::right << std::setw(9) << r.count << std::setw(12) << std::fixed << std::setprecision(0)
+                  << r.throughput << std::setw(12) << r.fill_rate << std::setw(8) << r.p50 << std::setw(8) << r.p90 << std::setw(8) << r.p99
+                  << std::setw(9) << r.p999 << std::setw(10) << r.max << "\n";
+    }
+    std::cout << "\nLatencies in ns (Timer: " << Timer().getBackend().name() << "); batch rows credit each\n"
+              << "order with its burst's time / burst size (\"single\" = one matchOrder per order)\n";
+}
+
+std::string toJson(const BenchConfig& config, const std::vector<BenchResult>& results) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << "{\n  \"config\": {"
+        << "\"orders\": " << config.orders << ", \"deep_orders\": " << config.deep_orders
+        << ", \"price_dist\": \"" << config.price_dist << "\", \"price_range\": " << config.price_range
+        << ", \"size_dist\": \"" << config.size_dist << "\", \"size_mean\": " << config.size_mean
+        << ", \"sweep_levels\": " << config.sweep_levels << ", \"sweep_depth\": " << config.sweep_depth
+        << ", \"seed\": " << config.seed
+        << ", \"batch_sizes\": [";
+    for (size_t i = 0; i < config.batch_sizes.size(); ++i) {
+        out << (i ? ", " : "") << config.batch_sizes[i];
+    }
+    out << "]"
+        << ", \"timer\": \"" << Timer().getBackend().name() << "\"},\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    {\"workload\": \"" << r.workload << "\", \"book\": \"" << r.book
+            << "\", \"operation\": \"" << r.operation << "\", \"count\": " << r.count
+            << ", \"throughput_ops\": " << r.throughput << ", \"throughput_fills\": " << r.fill_rate
+            << ", \"resting_after\": " << r.resting_after
+            << ", \"latency_ns\": {\"mean\": " << r.mean << ", \"min\": " << r.min
+            << ", \"p50\": " << r.p50 << ", \"p90\": " << r.p90 << ", \"p99\": " << r.p99
+            << ", \"p99.9\": " << r.p999 << ", \"p99.99\": " << r.p9999 << ", \"max\": " << r.max << "}}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+void usage() {
+    std::cout << "Usage: bench_orderbook [options]\n"
+              << "  --workloads LIST    comma list of add,cancel,sweep,deep,deep-sweep,batch (default: all)\n"
+              << "  --orders N          timed operations per workload (200000)\n"
+              << "  --deep-orders N     resting orders before the deep workloads (1000000)\n"
+              << "  --price-dist D      uniform | exponential (exponential)\n"
+              << "  --price-range T     max distance from mid in ticks (50)\n"
+              << "  --size-dist D       fixed | uniform | lognormal (uniform)\n"
+              << "  --size-mean N       mean order size (100)\n"
+              << "  --sweep-levels N    levels per side refilled for sweeps (20)\n"
+              << "  --sweep-depth N     resting orders each deep-sweep order fills (64)\n"
+              << "  --batch-sizes LIST  matchOrders batch sizes for the batch workload (1,8,64,512)\n"
+              << "  --seed N            generator seed (42)\n"
+              << "  --json PATH         write results as JSON (- for stdout)\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        }
+        if (!value) {
+            std::cerr << "Missing value for " << arg << "\n";
+            usage();
+            return 1;
+        }
+        ++i;
+        if (arg == "--workloads") config.workloads = value;
+        else if (arg == "--orders") config.orders = std::strtoul(value, nullptr, 10);
+        else if (arg == "--deep-orders") config.deep_orders = std::strtoul(value, nullptr, 10);
+        else if (arg == "--price-dist") config.price_dist = value;
+        else if (arg == "--price-range") config.price_range = std::atoi(value);
+        else if (arg == "--size-dist") config.size_dist = value;
+        else if (arg == "--size-mean") config.size_mean = std::atoi(value);
+        else if (arg == "--sweep-levels") config.sweep_levels = std::atoi(value);
+        else if (arg == "--sweep-depth") config.sweep_depth = std::atoi(value);
+        else if (arg == "--batch-sizes") {
+            config.batch_sizes.clear();
+            std::stringstream list(value);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                size_t size = std::strtoul(item.c_str(), nullptr, 10);
+                if (size) config.batch_sizes.push_back(size);
+            }
+        }
+        else if (arg == "--seed") config.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--json") config.json_path = value;
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            usage();
+            return 1;
+        }
+    }
+
+    bool json_stdout = config.json_path == "-";
+    std::ostream& log = json_stdout ? std::cerr : std::cout;
+
+    log << "\n====================================================================\n";
+    log << "                  Order Book Micro-Benchmark\n";
+    log << "====================================================================\n";
+    log << "Orders/workload: " << config.orders << ", deep book: " << config.deep_orders
+        << " resting, price: " << config.price_dist << " (" << config.price_range << " ticks)"
+        << ", size: " << config.size_dist << " (mean " << config.size_mean << ")\n\n";
+
+    std::vector<BenchResult> results;
+    auto wants = [&config](const char* name) {
+        return ("," + config.workloads + ",").find(std::string(",") + name + ",") != std::string::npos;
+    };
+    if (wants("add")) runAllVariants(makeAddOnly(config), results);
+    if (wants("cancel")) runAllVariants(makeCancelHeavy(config), results);
+    if (wants("sweep")) runAllVariants(makeSweep(config), results);
+    if (wants("deep")) runAllVariants(makeDeep(config), results);
+    if (wants("deep-sweep")) runAllVariants(makeDeepSweep(config), results);
+    if (wants("batch")) runAllBatchSizes(config, makeBatchFlow(config), results);
+
+    if (!json_stdout) printTable(results);
+
+    if (!config.json_path.empty()) {
+        std::string json = toJson(config, results);
+        if (json_stdout) {
+            std::cout << json;
+        } else {
+            std::ofstream file(config.json_path);
+            file << json;
+            std::cout << "JSON written to " << config.json_path << "\n";
+        }
+    }
+    std::cout << "\n";
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <iomanip>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+#include "../include/EngineRouter.hpp"
+#include "../include/Price.hpp"
+#include "../include/Timer.hpp"
+
+using PriceType = PriceTicks;
+using OrderIdType = int;
+using RouterType = EngineRouter<PriceType, OrderIdType>;
+
+// Pre-generated order intent (generation stays out of the timed region)
+struct Intent {
+    size_t symbol_index;
+    PriceType price;
+    int quantity;
+    bool is_buy;
+};
+
+// Multi-symbol synthetic load: independent per-symbol random walks in ticks,
+// orders placed around the mid so a fraction of them cross
+std::vector<Intent> generateLoad(size_t num_symbols, size_t num_orders) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> step(-2, 2);
+    std::uniform_int_distribution<int> offset(-3, 6);
+    std::uniform_int_distribution<int> size(1, 10);
+
+    std::vector<PriceType> mids(num_symbols, 15000);
+    std::vector<Intent> load;
+    load.reserve(num_orders);
+
+    for (size_t i = 0; i < num_orders; ++i) {
+        size_t s = i % num_symbols;
+        mids[s] += step(rng);
+        bool is_buy = (rng() & 1) != 0;
+        PriceType away = offset(rng);
+        PriceType price = is_buy ? mids[s] - away : mids[s] + away;
+        load.push_back({s, price, size(rng) * 10, is_buy});
+    }
+    return load;
+}
+
+// Push the whole load through a router with num_shards shards; returns orders/s
+double runShardCount(size_t num_shards, const std::vector<std::string>& symbols,
+                     const std::vector<Intent>& load, double baseline_rate) {
+    RouterType router(num_shards);
+
+    std::vector<SymbolId> ids;
+    for (const auto& symbol : symbols) ids.push_back(router.addSymbol(symbol));
+
+    router.start();
+
+    Timer timer;
+    timer.start();
+    for (const auto& intent : load) {
+        router.submit(ids[intent.symbol_index], intent.price, intent.quantity, intent.is_buy);
+    }
+    router.stop();
+    long long elapsed_ns = timer.stop();
+
+    double rate = load.size() * 1e9 / elapsed_ns;
+    std::cout << std::right << std::setw(8) << num_shards
+              << std::setw(16) << std::fixed << std::setprecision(0) << rate
+              << std::setw(12) << std::setprecision(2)
+              << (baseline_rate > 0 ? rate / baseline_rate : 1.0)
+              << std::setw(14) << router.getTradeCount() << "\n";
+    return rate;
+}
+
+int main(int argc, char* argv[]) {
+    size_t num_orders = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t num_symbols = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 64;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "\n====================================================================\n";
+    std::cout << "        Sharded Matching Engine - Multi-Symbol Throughput\n";
+    std::cout << "====================================================================\n";
+    std::cout << "Orders: " << num_orders << ", Symbols: " << num_symbols
+              << ", Hardware threads: " << cores << "\n\n";
+
+    std::vector<std::string> symbols;
+    for (size_t i = 0; i < num_symbols; ++i) symbols.push_back("SYM" + std::to_string(i));
+    auto load = generateLoad(num_symbols, num_orders);
+
+    std::cout << std::right << std::setw(8) << "Shards" << std::setw(16) << "Orders/s"
+              << std::setw(12) << "Speedup" << std::setw(14) << "Trades" << "\n";
+    std::cout << std::string(50, '-') << "\n";
+
+    // One shard is the scaling baseline, then powers of two up to the core count
+    double baseline_rate = runShardCount(1, symbols, load, 0.0);
+    for (size_t shards = 2; shards <= std::max<size_t>(cores, 2); shards *= 2) {
+        runShardCount(shards, symbols, load, baseline_rate);
+    }
+
+    std::cout << "\nNote: the producer thread occupies one core; speedup is linear\n"
+              << "until shard threads plus the producer exceed the hardware threads.\n\n";
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include "../include/Timer.hpp"
+#include "../include/LatencyHistogram.hpp"
+
+// Keeps the timestamp reads from being optimized away
+volatile uint64_t g_sink = 0;
+
+// Cost of reading the clock: back-to-back timestamps over many iterations,
+// timed as a whole with steady_clock
+template <typename Backend>
+double readCostNs(const Backend& backend, int iterations) {
+    uint64_t sink = 0;
+    uint64_t begin_ns = timer_detail::steadyNs();
+    for (int i = 0; i < iterations; ++i) {
+        sink += backend.end();
+    }
+    uint64_t end_ns = timer_detail::steadyNs();
+    g_sink = sink;
+    return static_cast<double>(end_ns - begin_ns) / iterations;
+}
+
+// Cost of a full start()/stop() pair, and the smallest interval each
+// backend can resolve (stop() immediately after start())
+template <typename Backend>
+void benchBackend(int iterations) {
+    BasicTimer<Backend> timer;
+    const Backend& backend = timer.getBackend();
+
+    double read_ns = readCostNs(backend, iterations);
+
+    long long total = 0;
+    uint64_t begin_ns = timer_detail::steadyNs();
+    for (int i = 0; i < iterations; ++i) {
+        timer.start();
+        total += timer.stop();
+    }
+    double pair_ns = static_cast<double>(timer_detail::steadyNs() - begin_ns) / iterations;
+    g_sink = static_cast<uint64_t>(total);
+
+    LatencyHistogram empty_interval;
+    for (int i = 0; i < iterations; ++i) {
+        timer.start();
+        empty_interval.record(timer.stop());
+    }
+
+    std::cout << std::left << std::setw(14) << Backend::name()
+              << std::setw(8) << (backend.usingTsc() ? "tsc" : "steady")
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << read_ns
+              << std::setw(16) << pair_ns
+              << std::setw(14) << empty_interval.percentile(50.0)
+              << std::setw(12) << empty_interval.percentile(99.0) << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = (argc > 1) ? std::atoi(argv[1]) : 5000000;
+
+    const auto& calibration = timer_detail::tscCalibration();
+
+    std::cout << "\n====================================================================\n";
+    std::cout << "                  Timer Backend Overhead\n";
+    std::cout << "====================================================================\n";
+    std::cout << "Invariant TSC: " << (calibration.invariant ? "yes" : "no")
+              << ", TSC usable: " << (calibration.usable ? "yes" : "no");
+    if (calibration.usable) {
+        std::cout << ", calibrated " << std::fixed << std::setprecision(3)
+                  << (1.0 / calibration.ns_per_tick) << " GHz";
+    }
+    std::cout << "\nTimer (compile-time default): " << Timer().getBackend().name()
+              << ", iterations: " << iterations << "\n\n";
+
+    std::cout << std::left << std::setw(14) << "Backend" << std::setw(8) << "Source"
+              << std::right << std::setw(12) << "Read (ns)" << std::setw(16) << "start+stop (ns)"
+              << std::setw(14) << "Floor P50" << std::setw(12) << "Floor P99" << "\n";
+    std::cout << std::string(76, '-') << "\n";
+
+    benchBackend<SteadyClockBackend>(iterations);
+    benchBackend<TscBackend>(iterations);
+
+    std::cout << "\nFloor = interval reported by stop() right after start() (ns).\n\n";
+    return 0;
+}
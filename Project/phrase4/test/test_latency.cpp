@@ -1,16 +1,26 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
-#include <numeric>
-#include <cmath>
 #include <iomanip>
 #include <thread>
+#include <type_traits>
+#include <random>
+#include <cctype>
+#include <cstdio>
+#include <map>
 #include "../include/Order.hpp"
 #include "../include/OrderBook.hpp"
+#include "../include/MapOrderBook.hpp"
 #include "../include/MatchingEngine.hpp"
 #include "../include/OrderManager.hpp"
 #include "../include/MarketData.hpp"
 #include "../include/Timer.hpp"
+#include "../include/Price.hpp"
+#include "../include/TradeLogger.hpp"
+#include "../include/LatencyHistogram.hpp"
+#include "../include/Snapshot.hpp"
+#include "../include/StageProbe.hpp"
+#include "../include/TraceZone.hpp"
 
 using PriceType = double;
 using OrderIdType = int;
@@ -27,27 +37,13 @@ struct TestConfig {
     bool use_memory_pool;
 };
 
+// Histogram files are written here when a directory is given on the command line
+std::string g_export_dir;
+
 // Detailed latency analysis
-void printLatencyReport(const std::string& test_name, const std::vector<long long>& latencies) {
+void printLatencyReport(const std::string& test_name, const LatencyHistogram& latencies) {
     if (latencies.empty()) return;
 
-    auto sorted = latencies;
-    std::sort(sorted.begin(), sorted.end());
-
-    auto min = sorted.front();
-    auto max = sorted.back();
-    double mean = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
-
-    double variance = 0.0;
-    for (auto l : latencies) variance += (l - mean) * (l - mean);
-    double stddev = std::sqrt(variance / latencies.size());
-
-    auto p50 = sorted[sorted.size() / 2];
-    auto p90 = sorted[static_cast<size_t>(sorted.size() * 0.90)];
-    auto p95 = sorted[static_cast<size_t>(sorted.size() * 0.95)];
-    auto p99 = sorted[static_cast<size_t>(sorted.size() * 0.99)];
-    auto p999 = sorted[static_cast<size_t>(sorted.size() * 0.999)];
-
     std::cout << "\n" << std::string(70, '=') << "\n";
     std::cout << "Test: " << test_name << "\n";
     std::cout << std::string(70, '-') << "\n";
@@ -62,17 +58,38 @@ void printLatencyReport(const std::string& test_name, const std::vector<long lon
                   << (ns_value / 1000.0) << "\n";
     };
 
-    printRow("Min", min);
-    printRow("Max", max);
-    printRow("Mean", static_cast<long long>(mean));
-    printRow("Std Dev", static_cast<long long>(stddev));
-    printRow("Median (P50)", p50);
-    printRow("P90", p90);
-    printRow("P95", p95);
-    printRow("P99", p99);
-    printRow("P99.9", p999);
+    printRow("Min", latencies.min());
+    printRow("Max", latencies.max());
+    printRow("Mean", static_cast<long long>(latencies.mean()));
+    printRow("Std Dev", static_cast<long long>(latencies.stddev()));
+    printRow("Median (P50)", latencies.percentile(50.0));
+    printRow("P90", latencies.percentile(90.0));
+    printRow("P95", latencies.percentile(95.0));
+    printRow("P99", latencies.percentile(99.0));
+    printRow("P99.9", latencies.percentile(99.9));
+    printRow("P99.99", latencies.percentile(99.99));
     
     std::cout << std::string(70, '=') << "\n";
+
+    if (!g_export_dir.empty()) {
+        // File name from the test name: alphanumerics kept, the rest '_'
+        std::string file;
+        for (char c : test_name) file += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+        latencies.exportDistribution(g_export_dir + "/" + file + ".hgrm");
+    }
+}
+
+// Rest `per_level` orders of 100 on each of `levels` price levels per side,
+// stepping out from 99.99 (bids) and 100.01 (asks) by 0.01
+template <typename BookType, typename ManagerType>
+void replenishBook(BookType& order_book, ManagerType& order_manager, SymbolId symbol,
+                   int levels, int per_level) {
+    for (int level = 0; level < levels; ++level) {
+        for (int k = 0; k < per_level; ++k) {
+            order_book.addBuyOrder(order_manager.createOrder(symbol, 99.99 - level * 0.01, 100, true));
+            order_book.addSellOrder(order_manager.createOrder(symbol, 100.01 + level * 0.01, 100, false));
+        }
+    }
 }
 
 // Test 1: Basic latency test
@@ -80,12 +97,13 @@ void testBasicLatency(int num_iterations) {
     std::cout << "\n[TEST 1] Basic Tick-to-Trade Latency\n";
     
     OrderBookType order_book("TEST");
+    const SymbolId symbol = internSymbol("TEST");
     MatchingEngineType matching_engine(order_book);
     OrderManagerType order_manager;
     MarketDataFeed market_feed(100.0);
 
-    std::vector<long long> latencies;
-    latencies.reserve(num_iterations);
+    LatencyHistogram latencies;
+    stage_probe::reset();
 
     Timer timer;
 
@@ -93,20 +111,29 @@ void testBasicLatency(int num_iterations) {
         timer.start();
 
         // Generate tick
-        auto tick = market_feed.generateTick("TEST");
+        HFT_PROBE_BEGIN(tick_probe, "tick");
+        auto tick = market_feed.generateTick(symbol);
+        HFT_PROBE_END(tick_probe);
         
         // Create order
         bool is_buy = (i % 2 == 0);
         double price = is_buy ? tick.bid_price : tick.ask_price;
-        auto order = order_manager.createOrder("TEST", price, 100, is_buy);
+        HFT_PROBE_BEGIN(create_probe, "create");
+        auto order = order_manager.createOrder(symbol, price, 100, is_buy);
+        HFT_PROBE_END(create_probe);
         
         // Match order
-        matching_engine.matchOrder(std::move(order));
+        {
+            HFT_PROBE_SCOPE("match");
+            matching_engine.matchOrder(std::move(order));
+        }
 
-        latencies.push_back(timer.stop());
+        latencies.record(timer.stop());
+        HFT_PROBE_DRAIN();
     }
 
     printLatencyReport("Basic Latency Test", latencies);
+    stage_probe::printReport(std::cout, "Basic Latency Test");
 }
 
 // Test 2: High-load latency test
@@ -114,37 +141,47 @@ void testHighLoadLatency(int num_iterations) {
     std::cout << "\n[TEST 2] High-Load Latency Test\n";
     
     OrderBookType order_book("LOAD");
+    const SymbolId symbol = internSymbol("LOAD");
     MatchingEngineType matching_engine(order_book);
     OrderManagerType order_manager;
     MarketDataFeed market_feed(150.0);
 
     // Pre-populate order book
     for (int i = 0; i < 1000; ++i) {
-        auto tick = market_feed.generateTick("LOAD");
-        auto buy = order_manager.createOrder("LOAD", tick.bid_price, 100, true);
-        auto sell = order_manager.createOrder("LOAD", tick.ask_price, 100, false);
+        auto tick = market_feed.generateTick(symbol);
+        auto buy = order_manager.createOrder(symbol, tick.bid_price, 100, true);
+        auto sell = order_manager.createOrder(symbol, tick.ask_price, 100, false);
         order_book.addBuyOrder(std::move(buy));
         order_book.addSellOrder(std::move(sell));
     }
 
-    std::vector<long long> latencies;
-    latencies.reserve(num_iterations);
+    LatencyHistogram latencies;
+    stage_probe::reset();
     Timer timer;
 
     for (int i = 0; i < num_iterations; ++i) {
         timer.start();
 
-        auto tick = market_feed.generateTick("LOAD");
+        HFT_PROBE_BEGIN(tick_probe, "tick");
+        auto tick = market_feed.generateTick(symbol);
+        HFT_PROBE_END(tick_probe);
         bool is_buy = (i % 2 == 0);
         double price = is_buy ? tick.ask_price + 0.5 : tick.bid_price - 0.5;
         
-        auto order = order_manager.createOrder("LOAD", price, 50, is_buy);
-        matching_engine.matchOrder(std::move(order));
+        HFT_PROBE_BEGIN(create_probe, "create");
+        auto order = order_manager.createOrder(symbol, price, 50, is_buy);
+        HFT_PROBE_END(create_probe);
+        {
+            HFT_PROBE_SCOPE("match");
+            matching_engine.matchOrder(std::move(order));
+        }
 
-        latencies.push_back(timer.stop());
+        latencies.record(timer.stop());
+        HFT_PROBE_DRAIN();
     }
 
     printLatencyReport("High-Load Latency Test", latencies);
+    stage_probe::printReport(std::cout, "High-Load Latency Test");
 }
 
 // Test 3: Burst latency test
@@ -153,33 +190,43 @@ void testBurstLatency(int num_bursts, int burst_size) {
               << burst_size << " orders)\n";
     
     OrderBookType order_book("BURST");
+    const SymbolId symbol = internSymbol("BURST");
     MatchingEngineType matching_engine(order_book);
     OrderManagerType order_manager;
     MarketDataFeed market_feed(200.0);
 
-    std::vector<long long> latencies;
-    latencies.reserve(num_bursts * burst_size);
+    LatencyHistogram latencies;
+    stage_probe::reset();
     Timer timer;
 
     for (int burst = 0; burst < num_bursts; ++burst) {
         for (int i = 0; i < burst_size; ++i) {
             timer.start();
 
-            auto tick = market_feed.generateTick("BURST");
+            HFT_PROBE_BEGIN(tick_probe, "tick");
+            auto tick = market_feed.generateTick(symbol);
+            HFT_PROBE_END(tick_probe);
             bool is_buy = (i % 2 == 0);
             double price = is_buy ? tick.bid_price : tick.ask_price;
             
-            auto order = order_manager.createOrder("BURST", price, 75, is_buy);
-            matching_engine.matchOrder(std::move(order));
+            HFT_PROBE_BEGIN(create_probe, "create");
+            auto order = order_manager.createOrder(symbol, price, 75, is_buy);
+            HFT_PROBE_END(create_probe);
+            {
+                HFT_PROBE_SCOPE("match");
+                matching_engine.matchOrder(std::move(order));
+            }
 
-            latencies.push_back(timer.stop());
+            latencies.record(timer.stop());
         }
         
-        // Small pause between bursts
+        // Small pause between bursts; fold the burst's probe samples first
+        HFT_PROBE_DRAIN();
         std::this_thread::sleep_for(std::chrono::microseconds(100));
     }
 
     printLatencyReport("Burst Latency Test", latencies);
+    stage_probe::printReport(std::cout, "Burst Latency Test");
 }
 
 // Test 4: Consistency test across different loads
@@ -190,25 +237,25 @@ void testLatencyConsistency() {
     
     for (int load : load_sizes) {
         OrderBookType order_book("CONSISTENCY");
+        const SymbolId symbol = internSymbol("CONSISTENCY");
         MatchingEngineType matching_engine(order_book);
         OrderManagerType order_manager;
         MarketDataFeed market_feed(180.0);
 
-        std::vector<long long> latencies;
-        latencies.reserve(load);
+        LatencyHistogram latencies;
         Timer timer;
 
         for (int i = 0; i < load; ++i) {
             timer.start();
 
-            auto tick = market_feed.generateTick("CONSISTENCY");
+            auto tick = market_feed.generateTick(symbol);
             bool is_buy = (i % 2 == 0);
             double price = is_buy ? tick.bid_price : tick.ask_price;
             
-            auto order = order_manager.createOrder("CONSISTENCY", price, 100, is_buy);
+            auto order = order_manager.createOrder(symbol, price, 100, is_buy);
             matching_engine.matchOrder(std::move(order));
 
-            latencies.push_back(timer.stop());
+            latencies.record(timer.stop());
         }
 
         std::string test_name = "Load: " + std::to_string(load) + " orders";
@@ -228,29 +275,29 @@ void runComparativeTests() {
     
     for (int size : book_sizes) {
         OrderBookType order_book("COMP");
+        const SymbolId symbol = internSymbol("COMP");
         MatchingEngineType matching_engine(order_book);
         OrderManagerType order_manager;
         MarketDataFeed market_feed(160.0);
 
         // Pre-populate
         for (int i = 0; i < size; ++i) {
-            auto tick = market_feed.generateTick("COMP");
-            auto buy = order_manager.createOrder("COMP", tick.bid_price, 100, true);
-            auto sell = order_manager.createOrder("COMP", tick.ask_price, 100, false);
+            auto tick = market_feed.generateTick(symbol);
+            auto buy = order_manager.createOrder(symbol, tick.bid_price, 100, true);
+            auto sell = order_manager.createOrder(symbol, tick.ask_price, 100, false);
             order_book.addBuyOrder(std::move(buy));
             order_book.addSellOrder(std::move(sell));
         }
 
-        std::vector<long long> latencies;
-        latencies.reserve(1000);
+        LatencyHistogram latencies;
         Timer timer;
 
         for (int i = 0; i < 1000; ++i) {
             timer.start();
-            auto tick = market_feed.generateTick("COMP");
-            auto order = order_manager.createOrder("COMP", tick.bid_price, 100, true);
+            auto tick = market_feed.generateTick(symbol);
+            auto order = order_manager.createOrder(symbol, tick.bid_price, 100, true);
             matching_engine.matchOrder(std::move(order));
-            latencies.push_back(timer.stop());
+            latencies.record(timer.stop());
         }
 
         std::string test_name = "Order Book Size: " + std::to_string(size);
@@ -258,7 +305,769 @@ void runComparativeTests() {
     }
 }
 
-int main() {
+// Stress-style workload on a cent grid against one book implementation.
+// Integral price types run in ticks (1 tick = $0.01).
+template <typename BookType, typename BookPriceType>
+LatencyHistogram runBookWorkload(int resting_orders, int num_orders, long long& total_ns) {
+    using EngineType = MatchingEngine<BookPriceType, OrderIdType, BookType>;
+    using ManagerType = OrderManager<BookPriceType, OrderIdType>;
+
+    BookType order_book("BOOK");
+    const SymbolId symbol = internSymbol("BOOK");
+    EngineType matching_engine(order_book);
+    ManagerType order_manager;
+    MarketDataFeed market_feed(150.0);
+    TickSize tick_size(0.01);
+
+    auto toBookPrice = [&tick_size](double price) -> BookPriceType {
+        if (std::is_integral<BookPriceType>::value) {
+            return static_cast<BookPriceType>(tick_size.toTicks(price));
+        }
+        return static_cast<BookPriceType>(std::round(price * 100.0) / 100.0);
+    };
+
+    // Deep resting book spread over many price levels
+    for (int i = 0; i < resting_orders; ++i) {
+        auto tick = market_feed.generateTick(symbol);
+        double offset = 0.05 + (i % 40) * 0.01;
+        order_book.addBuyOrder(order_manager.createOrder(symbol, toBookPrice(tick.bid_price - offset), 100, true));
+        order_book.addSellOrder(order_manager.createOrder(symbol, toBookPrice(tick.ask_price + offset), 100, false));
+    }
+
+    LatencyHistogram latencies;
+    Timer timer;
+    Timer total_timer;
+    total_timer.start();
+
+    for (int i = 0; i < num_orders; ++i) {
+        timer.start();
+
+        auto tick = market_feed.generateTick(symbol);
+        bool is_buy = (i % 3 != 0);
+        BookPriceType price = toBookPrice(is_buy ? tick.bid_price : tick.ask_price);
+
+        auto order = order_manager.createOrder(symbol, price, 50 + (i % 10) * 10, is_buy);
+        matching_engine.matchOrder(std::move(order));
+
+        latencies.record(timer.stop());
+    }
+
+    total_ns = total_timer.stop();
+    return latencies;
+}
+
+// Test 5: comparison of order book implementations
+void testBookImplementations() {
+    std::cout << "\n[TEST 5] Order Book Implementation: multimap vs price levels vs tick ladder\n";
+
+    const int resting_orders = 20000;
+    const int num_orders = 100000;
+
+    long long map_ns = 0;
+    auto map_latencies = runBookWorkload<MapOrderBook<PriceType, OrderIdType>, PriceType>(
+        resting_orders, num_orders, map_ns);
+    printLatencyReport("MapOrderBook<double> (multimap node per order)", map_latencies);
+
+    long long level_ns = 0;
+    auto level_latencies = runBookWorkload<OrderBookType, PriceType>(
+        resting_orders, num_orders, level_ns);
+    printLatencyReport("OrderBook<double> (price levels + intrusive FIFO)", level_latencies);
+
+    long long ladder_ns = 0;
+    auto ladder_latencies = runBookWorkload<OrderBook<PriceTicks, OrderIdType>, PriceTicks>(
+        resting_orders, num_orders, ladder_ns);
+    printLatencyReport("OrderBook<int64_t> (tick ladder + bitmap)", ladder_latencies);
+
+    std::cout << "Throughput - MapOrderBook<double>: " << std::fixed << std::setprecision(0)
+              << (num_orders * 1e9 / map_ns) << " orders/s, OrderBook<double>: "
+              << (num_orders * 1e9 / level_ns) << " orders/s, OrderBook<int64_t>: "
+              << (num_orders * 1e9 / ladder_ns) << " orders/s\n";
+}
+
+// Test 6: deep aggressive sweeps that partially fill resting orders
+void testAggressiveSweep(int num_orders) {
+    std::cout << "\n[TEST 6] Deep Aggressive Sweep Latency\n";
+
+    OrderBookType order_book("SWEEP");
+    const SymbolId symbol = internSymbol("SWEEP");
+    MatchingEngineType matching_engine(order_book);
+    OrderManagerType order_manager;
+
+    LatencyHistogram latencies;
+    Timer timer;
+
+    for (int i = 0; i < num_orders; ++i) {
+        // Replenish both sides: 20 levels, 5 orders of 100 per level
+        if (order_book.getBuyOrderCount() < 50 || order_book.getSellOrderCount() < 50) {
+            replenishBook(order_book, order_manager, symbol, 20, 5);
+        }
+
+        timer.start();
+
+        // Each aggressive order crosses several levels and leaves a partial fill
+        bool is_buy = (i % 2 == 0);
+        double price = is_buy ? 101.0 : 99.0;
+        int quantity = 750 + (i % 7) * 30;
+        auto order = order_manager.createOrder(symbol, price, quantity, is_buy);
+        matching_engine.matchOrder(std::move(order));
+
+        latencies.record(timer.stop());
+    }
+
+    printLatencyReport("Deep Aggressive Sweep", latencies);
+}
+
+// Cancel-heavy flow: ~90% of added orders are cancelled before they trade
+template <typename BookPriceType>
+void runCancelHeavy(const std::string& test_name, int num_orders, BookPriceType mid, BookPriceType step) {
+    using BookType = OrderBook<BookPriceType, OrderIdType>;
+    using EngineType = MatchingEngine<BookPriceType, OrderIdType>;
+    using ManagerType = OrderManager<BookPriceType, OrderIdType>;
+
+    OrderPool<BookPriceType, OrderIdType> order_pool(1024);
+    order_pool.reserve(num_orders);
+    BookType order_book("CXL");
+    const SymbolId symbol = internSymbol("CXL");
+    EngineType matching_engine(order_book);
+    ManagerType order_manager(order_pool);
+    std::mt19937 rng(42);
+
+    std::vector<OrderIdType> live;
+    live.reserve(num_orders);
+    LatencyHistogram add_latencies;
+    LatencyHistogram cancel_latencies;
+    Timer timer;
+
+    for (int i = 0; i < num_orders; ++i) {
+        // Passive quote 1-20 steps away from mid
+        bool is_buy = (rng() & 1) != 0;
+        BookPriceType away = static_cast<BookPriceType>(1 + rng() % 20) * step;
+        BookPriceType price = is_buy ? mid - away : mid + away;
+
+        timer.start();
+        auto order = order_manager.createOrder(symbol, price, 100, is_buy);
+        OrderIdType id = order->id;
+        matching_engine.matchOrder(std::move(order));
+        add_latencies.record(timer.stop());
+        live.push_back(id);
+
+        if (rng() % 10 != 0 && !live.empty()) {
+            size_t victim = rng() % live.size();
+            timer.start();
+            matching_engine.cancelOrder(live[victim]);
+            order_manager.cancelOrder(live[victim]);
+            cancel_latencies.record(timer.stop());
+            live[victim] = live.back();
+            live.pop_back();
+        }
+    }
+
+    printLatencyReport(test_name + " - add", add_latencies);
+    printLatencyReport(test_name + " - cancel", cancel_latencies);
+    std::cout << "Resting orders: " << order_book.getTotalOrderCount()
+              << ", cancels: " << cancel_latencies.count() << "\n";
+}
+
+// Test 7: O(1) cancel under a realistic add/cancel mix
+void testCancelHeavy(int num_orders) {
+    std::cout << "\n[TEST 7] Cancel-Heavy Flow (90% of orders cancelled)\n";
+    runCancelHeavy<PriceType>("OrderBook<double>", num_orders, 150.0, 0.01);
+    runCancelHeavy<PriceTicks>("OrderBook<int64_t>", num_orders, 15000, 1);
+}
+
+// Sweep workload measured either through the vector-returning matchOrder
+// (with trade history) or the sink overload (fixed buffer, no history)
+LatencyHistogram runSinkWorkload(int num_orders, bool use_sink) {
+    OrderPool<PriceType, OrderIdType> order_pool(1024);
+    order_pool.reserve(4096);
+    OrderBookType order_book("SINK");
+    const SymbolId symbol = internSymbol("SINK");
+    MatchingEngineType matching_engine(order_book, !use_sink);
+    OrderManagerType order_manager(order_pool);
+    FixedTradeBuffer<MatchingEngineType::TradeType> fills(64);
+
+    LatencyHistogram latencies;
+    Timer timer;
+
+    for (int i = 0; i < num_orders; ++i) {
+        // Keep a few levels of resting liquidity on both sides
+        if (order_book.getBuyOrderCount() < 20 || order_book.getSellOrderCount() < 20) {
+            replenishBook(order_book, order_manager, symbol, 10, 4);
+        }
+
+        bool is_buy = (i % 2 == 0);
+        auto order = order_manager.createOrder(symbol, is_buy ? 101.0 : 99.0, 350, is_buy);
+
+        timer.start();
+        if (use_sink) {
+            fills.clear();
+            matching_engine.matchOrder(std::move(order), fills);
+        } else {
+            matching_engine.matchOrder(std::move(order));
+        }
+        latencies.record(timer.stop());
+    }
+    return latencies;
+}
+
+// Test 8: allocation-free trade sink vs vector result + history copy
+void testTradeSink(int num_orders) {
+    std::cout << "\n[TEST 8] matchOrder: vector result + history vs caller-supplied sink\n";
+    printLatencyReport("matchOrder -> std::vector (history on)", runSinkWorkload(num_orders, false));
+    printLatencyReport("matchOrder -> FixedTradeBuffer (history off)", runSinkWorkload(num_orders, true));
+}
+
+// Log batches of trades and flush after each; returns per-batch latencies
+LatencyHistogram runLoggingWorkload(LogFormat format, const std::string& filename,
+                                          int num_batches, int batch_size) {
+    using TradeType = MatchingEngineType::TradeType;
+    const SymbolId symbol = internSymbol("LOG");
+
+    const int64_t now_ns = engine_detail::tradeTimestampNs();
+    std::vector<TradeType> batch;
+    for (int i = 0; i < batch_size; ++i) {
+        batch.emplace_back(i, i + 1, symbol, 100.0 + i * 0.01, 100, now_ns);
+    }
+
+    LatencyHistogram latencies;
+    {
+        // Explicit flushes only, so each sample is one append + flush
+        TradeLogger<PriceType, OrderIdType> logger(filename, true, static_cast<size_t>(-1), format);
+        Timer timer;
+        for (int b = 0; b < num_batches; ++b) {
+            timer.start();
+            logger.logTrades(batch);
+            logger.flush();
+            latencies.record(timer.stop());
+        }
+    }
+    std::remove(filename.c_str());
+    return latencies;
+}
+
+// Test 9: text CSV logging vs memory-mapped binary journal
+void testTradeLogging(int num_batches, int batch_size) {
+    std::cout << "\n[TEST 9] Trade Logging: CSV text vs memory-mapped binary journal ("
+              << batch_size << " trades per flush)\n";
+
+    auto text = runLoggingWorkload(LogFormat::Text, "bench_trades.log", num_batches, batch_size);
+    auto binary = runLoggingWorkload(LogFormat::Binary, "bench_trades.bin", num_batches, batch_size);
+    printLatencyReport("Text logger: log + flush per batch", text);
+    printLatencyReport("Binary journal: log + flush per batch", binary);
+
+    auto perTrade = [&](const LatencyHistogram& latencies) {
+        return latencies.mean() / batch_size;
+    };
+    std::cout << std::fixed << std::setprecision(1)
+              << "Mean cost per trade: text " << perTrade(text) << " ns, binary "
+              << perTrade(binary) << " ns\n";
+}
+
+// Match with every fill logged through the sink; the logger is either
+// synchronous (flushes inline every batch_size trades) or async
+LatencyHistogram runLoggedMatching(int num_orders, bool async, const std::string& filename) {
+    OrderPool<PriceType, OrderIdType> order_pool(1024);
+    order_pool.reserve(4096);
+    OrderBookType order_book("LOGGED");
+    const SymbolId symbol = internSymbol("LOGGED");
+    MatchingEngineType matching_engine(order_book, false);
+    OrderManagerType order_manager(order_pool);
+
+    LatencyHistogram latencies;
+    {
+        TradeLogger<PriceType, OrderIdType> logger(filename, true, 1000);
+        if (async) logger.enableAsync();
+        auto log = [&logger](const MatchingEngineType::TradeType& trade) { logger.logTrade(trade); };
+
+        Timer timer;
+        for (int i = 0; i < num_orders; ++i) {
+            if (order_book.getBuyOrderCount() < 20 || order_book.getSellOrderCount() < 20) {
+                replenishBook(order_book, order_manager, symbol, 10, 4);
+            }
+
+            bool is_buy = (i % 2 == 0);
+            auto order = order_manager.createOrder(symbol, is_buy ? 101.0 : 99.0, 350, is_buy);
+
+            timer.start();
+            matching_engine.matchOrder(std::move(order), log);
+            latencies.record(timer.stop());
+        }
+    }
+    std::remove(filename.c_str());
+    return latencies;
+}
+
+// Test 10: inline batch flushes vs background writer thread
+void testAsyncLogging(int num_orders) {
+    std::cout << "\n[TEST 10] Match + Log: synchronous batch flush vs async writer thread\n";
+    printLatencyReport("Synchronous logger (flush every 1000 trades)",
+                       runLoggedMatching(num_orders, false, "bench_sync.log"));
+    printLatencyReport("Async logger (SPSC ring + writer thread)",
+                       runLoggedMatching(num_orders, true, "bench_async.log"));
+}
+
+// Test 11: order registration cost and state queries on the slab-backed OMS
+void testOrderManager(int num_orders) {
+    std::cout << "\n[TEST 11] OrderManager: createOrder + incremental state counters\n";
+
+    OrderPool<PriceType, OrderIdType> order_pool(1024);
+    order_pool.reserve(1024);
+    OrderManagerType order_manager(order_pool);
+    const SymbolId symbol = internSymbol("OMS");
+
+    LatencyHistogram create_latencies;
+    Timer timer;
+    for (int i = 0; i < num_orders; ++i) {
+        timer.start();
+        auto order = order_manager.createOrder(symbol, 100.0 + (i % 50) * 0.01, 100, (i & 1) != 0);
+        create_latencies.record(timer.stop());
+
+        if (i % 3 == 0) order_manager.updateRemainingQuantity(order->id, 40);
+        if (i % 7 == 0) order_manager.cancelOrder(order->id);
+    }
+    printLatencyReport("createOrder (pooled order + slab record)", create_latencies);
+
+    timer.start();
+    size_t partial = order_manager.getOrdersByState(OrderState::PARTIAL_FILLED);
+    size_t cancelled = order_manager.getOrdersByState(OrderState::CANCELLED);
+    long long query_ns = timer.stop();
+    std::cout << "getOrdersByState over " << order_manager.getTotalOrders() << " orders: "
+              << query_ns << " ns for 2 queries (partial " << partial
+              << ", cancelled " << cancelled << ")\n";
+}
+
+// Test 12: market data generation throughput, per tick vs SoA batches
+void testMarketDataGeneration(int num_ticks) {
+    std::cout << "\n[TEST 12] Market Data Generation: generateTick vs generateBatch (SoA)\n";
+
+    std::vector<SymbolId> symbols;
+    for (int i = 0; i < 16; ++i) symbols.push_back(internSymbol("MD" + std::to_string(i)));
+
+    MarketDataFeed scalar_feed(150.0, 42);
+    double checksum = 0.0;
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < num_ticks; ++i) {
+        checksum += scalar_feed.generateTick(symbols[i % symbols.size()]).bid_price;
+    }
+    long long scalar_ns = timer.stop();
+
+    const size_t batch_size = 4096;
+    MarketDataFeed batch_feed(150.0, 42);
+    TickBatch batch;
+    size_t generated = 0;
+    timer.start();
+    while (generated < static_cast<size_t>(num_ticks)) {
+        batch_feed.generateBatch(symbols.data(), symbols.size(), batch_size, batch);
+        checksum += batch.bid_price[0];
+        generated += batch.size();
+    }
+    long long batch_ns = timer.stop();
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "generateTick:  " << (static_cast<double>(scalar_ns) / num_ticks) << " ns/tick\n"
+              << "generateBatch: " << (static_cast<double>(batch_ns) / generated) << " ns/tick ("
+              << batch_size << " ticks per batch, " << symbols.size() << " symbols)\n"
+              << "(checksum " << checksum << ")\n";
+}
+
+// Top-N levels rebuilt from the order walk (reference for the depth view)
+template <typename BookType, typename PriceT>
+std::vector<DepthLevel<PriceT>> referenceDepth(const BookType& book, bool is_buy, size_t levels) {
+    std::vector<DepthLevel<PriceT>> result;
+    auto orders = is_buy ? book.getTopBuyOrders(book.getTotalOrderCount())
+                         : book.getTopSellOrders(book.getTotalOrderCount());
+    for (const auto* order : orders) {
+        if (result.empty() || result.back().price != order->price) {
+            if (result.size() == levels) break;
+            result.push_back(DepthLevel<PriceT>{order->price, 0, 0});
+        }
+        result.back().quantity += order->quantity;
+        ++result.back().order_count;
+    }
+    return result;
+}
+
+// Mixed passive/aggressive/cancel flow with the depth view on or off.
+// With verify set, the view is checked against a full rebuild and against
+// a consumer that only applies the per-call delta stream.
+template <typename BookPriceType>
+LatencyHistogram runDepthWorkload(int num_orders, size_t depth_levels, BookPriceType mid,
+                                  BookPriceType step, bool verify, size_t& mismatches) {
+    using BookType = OrderBook<BookPriceType, OrderIdType>;
+    using EngineType = MatchingEngine<BookPriceType, OrderIdType>;
+    using ManagerType = OrderManager<BookPriceType, OrderIdType>;
+
+    OrderPool<BookPriceType, OrderIdType> order_pool(1024);
+    order_pool.reserve(num_orders);
+    BookType order_book("DEPTH");
+    const SymbolId symbol = internSymbol("DEPTH");
+    EngineType matching_engine(order_book, false);
+    ManagerType order_manager(order_pool);
+    FixedTradeBuffer<Trade<BookPriceType, OrderIdType>> fills(1024);
+    order_book.enableDepth(depth_levels);
+
+    // Consumer-side book rebuilt only from delta updates
+    std::map<BookPriceType, std::pair<long long, uint32_t>> bids;
+    std::map<BookPriceType, std::pair<long long, uint32_t>> asks;
+    auto applyUpdates = [&]() {
+        for (const auto& update : order_book.getDepthUpdates()) {
+            auto& side = update.is_buy ? bids : asks;
+            if (update.quantity == 0) {
+                side.erase(update.price);
+            } else {
+                side[update.price] = {update.quantity, update.order_count};
+            }
+        }
+    };
+
+    std::mt19937 rng(7);
+    std::vector<OrderIdType> live;
+    live.reserve(num_orders);
+    LatencyHistogram latencies;
+    Timer timer;
+    mismatches = 0;
+
+    for (int i = 0; i < num_orders; ++i) {
+        bool is_buy = (rng() & 1) != 0;
+        bool aggressive = rng() % 8 == 0;
+        BookPriceType away = static_cast<BookPriceType>(1 + rng() % 30) * step;
+        BookPriceType price = aggressive ? (is_buy ? mid + away : mid - away)
+                                         : (is_buy ? mid - away : mid + away);
+        int quantity = aggressive ? 300 + static_cast<int>(rng() % 700) : 100;
+
+        timer.start();
+        auto order = order_manager.createOrder(symbol, price, quantity, is_buy);
+        OrderIdType id = order->id;
+        fills.clear();
+        matching_engine.matchOrder(std::move(order), fills);
+        latencies.record(timer.stop());
+        live.push_back(id);
+        if (verify) applyUpdates();
+
+        if (rng() % 3 == 0 && !live.empty()) {
+            size_t victim = rng() % live.size();
+            order_book.clearDepthUpdates();
+            matching_engine.cancelOrder(live[victim]);
+            live[victim] = live.back();
+            live.pop_back();
+            if (verify) applyUpdates();
+        }
+
+        if (verify && i % 256 == 0) {
+            const auto& depth = order_book.getDepth();
+            for (bool buy : {true, false}) {
+                auto expected = referenceDepth<BookType, BookPriceType>(order_book, buy, depth_levels);
+                size_t shown = buy ? depth.bidDepth() : depth.askDepth();
+                auto& consumer = buy ? bids : asks;
+                if (shown != expected.size() || consumer.size() != expected.size()) {
+                    ++mismatches;
+                    continue;
+                }
+                for (size_t k = 0; k < shown; ++k) {
+                    const auto& level = buy ? depth.bid(k) : depth.ask(k);
+                    auto it = consumer.find(level.price);
+                    if (level.price != expected[k].price || level.quantity != expected[k].quantity ||
+                        level.order_count != expected[k].order_count || it == consumer.end() ||
+                        it->second.first != level.quantity) {
+                        ++mismatches;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return latencies;
+}
+
+// Test 13: incrementally maintained L2 depth vs walking individual orders
+void testDepthView(int num_orders) {
+    std::cout << "\n[TEST 13] L2 Depth View (top 10 levels, incremental + delta stream)\n";
+
+    size_t mismatches = 0;
+    size_t tick_mismatches = 0;
+    runDepthWorkload<PriceType>(num_orders / 4, 10, 150.0, 0.01, true, mismatches);
+    runDepthWorkload<PriceTicks>(num_orders / 4, 10, 15000, 1, true, tick_mismatches);
+    std::cout << "Depth vs rebuilt book and delta consumer: " << mismatches << " / "
+              << tick_mismatches << " mismatches (double / tick prices)\n";
+
+    size_t unused = 0;
+    printLatencyReport("matchOrder, depth off",
+                       runDepthWorkload<PriceType>(num_orders, 0, 150.0, 0.01, false, unused));
+    printLatencyReport("matchOrder, depth on (10 levels)",
+                       runDepthWorkload<PriceType>(num_orders, 10, 150.0, 0.01, false, unused));
+
+    // Read cost: top 10 levels per side vs top 10 orders per side
+    OrderBookType order_book("DEPTHREAD");
+    const SymbolId symbol = internSymbol("DEPTHREAD");
+    OrderManagerType order_manager;
+    order_book.enableDepth(10);
+    replenishBook(order_book, order_manager, symbol, 40, 5);
+
+    const int reads = 100000;
+    long long checksum = 0;
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < reads; ++i) {
+        const auto& depth = order_book.getDepth();
+        for (size_t k = 0; k < depth.bidDepth(); ++k) checksum += depth.bid(k).quantity;
+        for (size_t k = 0; k < depth.askDepth(); ++k) checksum += depth.ask(k).quantity;
+    }
+    long long depth_ns = timer.stop();
+
+    timer.start();
+    for (int i = 0; i < reads; ++i) {
+        for (const auto* order : order_book.getTopBuyOrders(10)) checksum += order->quantity;
+        for (const auto* order : order_book.getTopSellOrders(10)) checksum += order->quantity;
+    }
+    long long orders_ns = timer.stop();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "getDepth() top 10 levels x2:        " << static_cast<double>(depth_ns) / reads << " ns/read\n"
+              << "getTopBuy/SellOrders(10) (orders): " << static_cast<double>(orders_ns) / reads
+              << " ns/read (covers only 2 levels here)\n"
+              << "(checksum " << checksum << ")\n";
+}
+
+// Test 14: warm restart from a snapshot vs rebuilding the book by replaying
+// its order flow through createOrder + addOrder
+void testSnapshotRestore(int num_orders) {
+    std::cout << "\n[TEST 14] Snapshot + Restore (" << num_orders << " resting orders)\n";
+
+    const std::string path = "bench_snapshot.snap";
+    const SymbolId symbol = internSymbol("SNAP");
+    std::mt19937 rng(14);
+    std::uniform_int_distribution<int> level(0, 1999);
+    std::uniform_int_distribution<int> size(1, 500);
+
+    // Non-crossing book: bids 80.00-99.99, asks 100.01-120.00; a few state changes
+    OrderPool<PriceType, OrderIdType> order_pool(4096);
+    order_pool.reserve(num_orders);
+    OrderManagerType order_manager(order_pool);
+    OrderBookType order_book("SNAP");
+    for (int i = 0; i < num_orders; ++i) {
+        bool is_buy = (i & 1) == 0;
+        double price = is_buy ? 99.99 - level(rng) * 0.01 : 100.01 + level(rng) * 0.01;
+        auto order = order_manager.createOrder(symbol, price, size(rng), is_buy);
+        if (i % 5 == 0) order_manager.updateRemainingQuantity(order->id, order->quantity);
+        order_book.addOrder(std::move(order));
+    }
+    for (int id = 1; id <= num_orders; id += 7) {
+        order_book.modifyOrder(id, 1);
+        order_manager.updateRemainingQuantity(id, 1);
+    }
+
+    // Capture (the pause matching would see): into a fresh buffer, then
+    // again into the same storage as SnapshotWriter::takeBuffer() hands back
+    Timer timer;
+    std::vector<SnapshotRecord> records;
+    long long capture_ns[2];
+    for (long long& pause_ns : capture_ns) {
+        records.clear();
+        timer.start();
+        records.reserve(order_manager.getTotalOrders() + order_book.getTotalOrderCount());
+        captureOrderManager(order_manager, records);
+        captureBook(order_book, records);
+        pause_ns = timer.stop();
+    }
+
+    timer.start();
+    bool written = SnapshotWriter::writeFile(path, records);
+    long long write_ns = timer.stop();
+
+    // Restore into a fresh pool/manager/book
+    OrderPool<PriceType, OrderIdType> restored_pool(4096);
+    restored_pool.reserve(num_orders);
+    OrderManagerType restored_manager(restored_pool);
+    OrderBookType restored_book("SNAP");
+    timer.start();
+    bool restored = false;
+    {
+        SnapshotReader snapshot(path);
+        restored = snapshot.isOpen() && restoreOrderManager(snapshot, restored_manager) &&
+                   restoreBook(snapshot, restored_manager, restored_book);
+    }
+    long long restore_ns = timer.stop();
+    std::remove(path.c_str());
+
+    // Baseline: rebuild by replaying every order in arrival order
+    OrderPool<PriceType, OrderIdType> replay_pool(4096);
+    replay_pool.reserve(num_orders);
+    OrderManagerType replay_manager(replay_pool);
+    OrderBookType replay_book("SNAP");
+    std::vector<const OrderType*> resting;
+    resting.reserve(order_book.getTotalOrderCount());
+    order_book.forEachOrder([&resting](const OrderType* order) { resting.push_back(order); });
+    std::vector<const OrderType*> arrival(resting);
+    std::sort(arrival.begin(), arrival.end(),
+              [](const OrderType* a, const OrderType* b) { return a->id < b->id; });
+    timer.start();
+    for (const OrderType* order : arrival) {
+        replay_book.addOrder(replay_manager.createOrder(symbol, order->price, order->quantity, order->is_buy));
+    }
+    long long replay_ns = timer.stop();
+
+    // Same orders in the same priority order, same manager records
+    size_t mismatches = 0;
+    size_t next = 0;
+    restored_book.forEachOrder([&](const OrderType* order) {
+        const OrderType* original = next < resting.size() ? resting[next] : nullptr;
+        if (!original || original->id != order->id || original->price != order->price ||
+            original->quantity != order->quantity || original->is_buy != order->is_buy) {
+            ++mismatches;
+        }
+        ++next;
+    });
+    if (next != resting.size()) ++mismatches;
+    for (OrderIdType id = 1; id <= num_orders; ++id) {
+        auto original = order_manager.getOrderInfo(id);
+        auto copy = restored_manager.getOrderInfo(id);
+        if (!copy || copy->state != original->state || copy->remaining_quantity != original->remaining_quantity ||
+            copy->price != original->price || copy->created_at != original->created_at) {
+            ++mismatches;
+        }
+    }
+    for (size_t state = 0; state < order_state_count; ++state) {
+        if (order_manager.getOrdersByState(static_cast<OrderState>(state)) !=
+            restored_manager.getOrdersByState(static_cast<OrderState>(state))) {
+            ++mismatches;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Snapshot records:             " << records.size() << " (" << order_book.getBuyLevelCount()
+              << " + " << order_book.getSellLevelCount() << " levels)\n"
+              << "Capture, fresh buffer:        " << capture_ns[0] / 1e6 << " ms (matching paused)\n"
+              << "Capture, reused buffer:       " << capture_ns[1] / 1e6 << " ms (matching paused)\n"
+              << "Write (background in app):    " << write_ns / 1e6 << " ms" << (written ? "" : " FAILED") << "\n"
+              << "Restore (map + bulk build):   " << restore_ns / 1e6 << " ms" << (restored ? "" : " FAILED") << "\n"
+              << "Rebuild by replaying adds:    " << replay_ns / 1e6 << " ms (book only)\n"
+              << "Restored vs original:         " << mismatches << " mismatches\n";
+}
+
+// Test 15: Cost of the probes themselves, so the stage split above can be
+// read net of it
+void testProbeOverhead(int num_iterations) {
+    std::cout << "\n[TEST 15] Stage Probe Overhead (empty probed scope)\n";
+    if (!stage_probe::enabled()) {
+        std::cout << "Probes compiled out (HFT_STAGE_PROBES=OFF): no overhead\n";
+        return;
+    }
+
+    Timer timer;
+    stage_probe::reset();
+    timer.start();
+    for (int i = 0; i < num_iterations; ++i) {
+        HFT_PROBE_SCOPE("empty");
+    }
+    long long elapsed_ns = timer.stop();
+
+    size_t overwritten = stage_probe::overwrittenSamples();
+
+    std::vector<stage_probe::StageStats> stats = stage_probe::collect();
+    auto empty = std::find_if(stats.begin(), stats.end(),
+                              [](const stage_probe::StageStats& stage) { return stage.name == "empty"; });
+
+    // A probe is two of these stamps; compare with the fenced Timer reads
+    const stage_probe::ThreadRing& ring = stage_probe::threadRing();
+    uint64_t stamp_sum = 0;
+    timer.start();
+    for (int i = 0; i < num_iterations; ++i) {
+        stamp_sum += ring.stamp();
+    }
+    long long stamp_ns = timer.stop();
+
+    const stage_probe::Backend& backend = timer.getBackend();
+    timer.start();
+    for (int i = 0; i < num_iterations; ++i) {
+        stamp_sum += backend.begin() + backend.end();
+    }
+    long long fenced_ns = timer.stop();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Probe cost (begin + end + record): " << static_cast<double>(elapsed_ns) / num_iterations
+              << " ns per probe (" << overwritten << " samples overwritten, no fold in the loop)\n"
+              << "Probe stamp:                       " << static_cast<double>(stamp_ns) / num_iterations
+              << " ns (fenced Timer begin + end: " << static_cast<double>(fenced_ns) / num_iterations
+              << " ns)" << (stamp_sum == 0 ? " (stamp stuck at 0)" : "") << "\n";
+    if (empty != stats.end()) {
+        std::cout << "Measured inside an empty probe:    P50 " << empty->latency.percentile(50.0)
+                  << " ns, P99 " << empty->latency.percentile(99.0) << " ns\n";
+    }
+    stage_probe::reset();
+}
+
+// Test 16: Trace zone cost, idle (no trace active) and recording, plus a
+// traced matching run to show what a timeline of the hot path costs
+void testTraceZoneOverhead(int num_iterations) {
+    std::cout << "\n[TEST 16] Trace Zone Overhead (Chrome trace timeline)\n";
+    if (!trace::enabled()) {
+        std::cout << "Trace zones compiled out (HFT_TRACE_ZONES=OFF): no overhead\n";
+        return;
+    }
+    const std::string path = "test_latency_trace.json";
+
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < num_iterations; ++i) {
+        HFT_TRACE_ZONE("idle");
+    }
+    long long idle_ns = timer.stop();
+
+    // A recording zone is two of these plus a 24-byte store
+    uint64_t stamp_sum = 0;
+    timer.start();
+    for (int i = 0; i < num_iterations; ++i) {
+        stamp_sum += trace_detail::stamp();
+    }
+    long long stamp_ns = timer.stop();
+
+    trace::start(path);
+    timer.start();
+    for (int i = 0; i < num_iterations; ++i) {
+        HFT_TRACE_ZONE("empty");
+    }
+    long long recording_ns = timer.stop();
+    trace::stop();
+
+    // The same order flow matched untraced, then traced
+    long long match_ns[2] = {0, 0};
+    for (int traced = 0; traced < 2; ++traced) {
+        OrderBookType order_book("TRACE");
+        const SymbolId symbol = internSymbol("TRACE");
+        MatchingEngineType matching_engine(order_book, false);
+        OrderManagerType order_manager;
+        MarketDataFeed market_feed(100.0, 42);
+        FixedTradeBuffer<MatchingEngineType::TradeType> fills(256);
+
+        if (traced) trace::start(path);
+        timer.start();
+        for (int i = 0; i < 100000; ++i) {
+            auto tick = market_feed.generateTick(symbol);
+            bool is_buy = (i % 2 == 0);
+            double price = is_buy ? tick.ask_price : tick.bid_price;
+            fills.clear();
+            matching_engine.matchOrder(order_manager.createOrder(symbol, price, 100, is_buy), fills);
+        }
+        match_ns[traced] = timer.stop();
+        if (traced) trace::stop();
+    }
+    std::remove(path.c_str());
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Idle zone (no trace active):   " << static_cast<double>(idle_ns) / num_iterations << " ns\n"
+              << "Stamp read (rdtsc):            " << static_cast<double>(stamp_ns) / num_iterations << " ns"
+              << (stamp_sum == 0 ? " (stamp stuck at 0)" : "") << "\n"
+              << "Recording zone (empty body):   " << static_cast<double>(recording_ns) / num_iterations << " ns\n"
+              << "100K orders, untraced:         " << match_ns[0] / 1e6 << " ms\n"
+              << "100K orders, traced:           " << match_ns[1] / 1e6 << " ms ("
+              << trace::writtenEvents() << " zones kept, " << trace::overwrittenEvents() << " overwritten)\n";
+}
+
+int main(int argc, char* argv[]) {
+    // Optional: directory to export each report's percentile distribution to
+    if (argc > 1) g_export_dir = argv[1];
+
     std::cout << "\n";
     std::cout << "====================================================================\n";
     std::cout << "        HFT System - Comprehensive Latency Benchmark\n";
@@ -271,6 +1080,18 @@ int main() {
     testBurstLatency(100, 100);
     testLatencyConsistency();
     runComparativeTests();
+    testBookImplementations();
+    testAggressiveSweep(20000);
+    testCancelHeavy(100000);
+    testTradeSink(100000);
+    testTradeLogging(2000, 100);
+    testAsyncLogging(100000);
+    testOrderManager(1000000);
+    testMarketDataGeneration(5000000);
+    testDepthView(200000);
+    testSnapshotRestore(1000000);
+    testProbeOverhead(1000000);
+    testTraceZoneOverhead(1000000);
 
     std::cout << "\n";
     std::cout << "====================================================================\n";
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include "../include/TradeJournal.hpp"
+
+// Convert a binary trade journal (TradeLogger LogFormat::Binary) into the
+// CSV layout written by the text logger.
+// Usage: journal_to_csv <journal.bin> [output.csv]   (stdout if no output)
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <journal.bin> [output.csv]\n";
+        return 1;
+    }
+
+    TradeJournalReader reader(argv[1]);
+    if (!reader.isOpen()) {
+        std::cerr << "Not a trade journal: " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (argc > 2) {
+        file.open(argv[2]);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open " << argv[2] << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = (argc > 2) ? static_cast<std::ostream&>(file) : std::cout;
+
+    out << "Timestamp,BuyOrderID,SellOrderID,Symbol,Price,Quantity\n";
+    out << std::fixed << std::setprecision(2);
+    for (uint64_t i = 0; i < reader.recordCount(); ++i) {
+        const TradeRecord& record = reader.record(i);
+        out << record.timestamp_ns << ","
+            << record.buy_order_id << ","
+            << record.sell_order_id << ","
+            << reader.symbol(record.symbol) << ","
+            << record.price << ","
+            << record.quantity << "\n";
+    }
+
+    if (argc > 2) {
+        std::cerr << "Wrote " << reader.recordCount() << " trades to " << argv[2] << "\n";
+    }
+    return 0;
+}